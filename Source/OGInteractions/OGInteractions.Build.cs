@@ -27,7 +27,8 @@ public class OGInteractions : ModuleRules
 			{
 				"Core",
 				"GameplayTags",
-				"OGAsync"
+				"NetCore",
+				"OGAsync",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -38,6 +39,7 @@ public class OGInteractions : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"Json",
 				"Slate",
 				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
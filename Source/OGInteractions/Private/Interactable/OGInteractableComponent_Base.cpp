@@ -3,10 +3,18 @@
 
 #include "Interactable/OGInteractableComponent_Base.h"
 
+#include "Components/MeshComponent.h"
 #include "Components/ShapeComponent.h"
+#include "Interactable/OGInteractableConveyanceProfile.h"
 #include "Interactor/OGInteractorComponent.h"
+#include "Interactor/OGInteractorInterface.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Replication/OGInteractableStateManager.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Subsystems/OGInteractionConveyanceSubsystem.h"
 #include "Utilities/OGInteractions_FunctionLibrary.h"
+#include "Utilities/OGInteractions_Stats.h"
 #include "Utilities/OGInteractions_Types.h"
 
 UOGInteractableComponent_Base::UOGInteractableComponent_Base()
@@ -19,21 +27,217 @@ void UOGInteractableComponent_Base::GetLifetimeReplicatedProps(TArray<FLifetimeP
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UOGInteractableComponent_Base, bDisabled);
+	// Push based, these change a handful of times per match at most
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	// Always notified, a write matching a predicted value still has to update bLastServerDisabled
+	Params.RepNotifyCondition = REPNOTIFY_Always;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UOGInteractableComponent_Base, bDisabled, Params);
+	Params.RepNotifyCondition = REPNOTIFY_OnChanged;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UOGInteractableComponent_Base, NetState, Params);
+	Params.Condition = COND_InitialOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UOGInteractableComponent_Base, Handle, Params);
+}
+
+void UOGInteractableComponent_Base::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Nothing replicates a value that matches the defaults, and no prediction can be pending yet
+	bLastServerDisabled = bDisabled;
+	AcquireHandle();
+
+	AActor* Owner = GetOwner();
+	if (bManageOwnerDormancy && !StateManager.IsValid() && Owner && Owner->HasAuthority() && Owner->GetIsReplicated() && Owner->NetDormancy == DORM_Awake)
+	{
+		Owner->SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void UOGInteractableComponent_Base::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* Manager = StateManager.Get())
+	{
+		Manager->RemoveInteractable(this);
+	}
+	StateManager.Reset();
+	if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+	{
+		Registry->UnregisterInteractable(this, GetQueryTarget());
+		Registry->ReleaseHandle(Handle);
+	}
+	Handle = FOGInteractableHandle();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UOGInteractableComponent_Base::AcquireHandle()
+{
+	auto* Registry = UOGInteractableRegistrySubsystem::Get(this);
+	if (Handle.IsValid() || !Registry)
+		return;
+
+	if (GetNetMode() != NM_Client)
+	{
+		Handle = Registry->AllocateHandle(this, false);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UOGInteractableComponent_Base, Handle, this);
+		if (bReplicateStateThroughManager && CanReplicateStateThroughManager() && GetNetMode() != NM_Standalone)
+		{
+			RegisterWithStateManager();
+		}
+	}
+	else if (GetOwnerRole() == ROLE_Authority)
+	{
+		// Spawned on this client, the server will never send a handle for it
+		Handle = Registry->AllocateHandle(this, true);
+	}
+	// Otherwise the server's handle arrives through OnRep_Handle
+}
+
+void UOGInteractableComponent_Base::OnRep_Handle(const FOGInteractableHandle& PreviousHandle)
+{
+	if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+	{
+		Registry->ReleaseHandle(PreviousHandle);
+		Registry->BindReplicatedHandle(Handle, this);
+	}
+}
+
+void UOGInteractableComponent_Base::RegisterWithStateManager()
+{
+	auto* Registry = UOGInteractableRegistrySubsystem::Get(this);
+	const auto* Owner = GetOwner();
+	auto* Manager = Registry && Owner ? Registry->FindOrSpawnStateManager(Owner->GetLevel(), Owner->GetActorLocation()) : nullptr;
+	if (!ensureAlwaysMsgf(Manager, TEXT("UOGInteractableComponent_Base::RegisterWithStateManager - No state manager for %s, it keeps replicating itself"), *GetNameSafe(Owner)))
+		return;
+
+	SetIsReplicated(false);
+	StateManager = Manager;
+	Manager->AddInteractable(this);
+}
+
+void UOGInteractableComponent_Base::ApplyManagedState(const FOGInteractableHandle& InHandle, bool bInDisabled, uint8 InNetState)
+{
+	if (Handle != InHandle)
+	{
+		const FOGInteractableHandle PreviousHandle = Handle;
+		Handle = InHandle;
+		OnRep_Handle(PreviousHandle);
+	}
+	bLastServerDisabled = bInDisabled;
+	if (bDisabled != bInDisabled)
+	{
+		bDisabled = bInDisabled;
+		HandleDisabledChanged();
+	}
+	if (NetState != InNetState)
+	{
+		NetState = InNetState;
+		OnRep_NetState();
+	}
+}
+
+void UOGInteractableComponent_Base::SetNetState(uint8 InNetState)
+{
+	if (NetState == InNetState)
+		return;
+
+	FlushOwnerDormancy();
+	NetState = InNetState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UOGInteractableComponent_Base, NetState, this);
+	if (auto* Manager = StateManager.Get())
+	{
+		Manager->MarkInteractableDirty(this);
+	}
+	OnRep_NetState();
+}
+
+void UOGInteractableComponent_Base::FlushOwnerDormancy() const
+{
+	AActor* Owner = GetOwner();
+	if (!bManageOwnerDormancy || !Owner || Owner->NetDormancy <= DORM_Awake)
+		return;
+
+	// DORM_DormantAll stays dormant, this only sends the pending changes
+	Owner->FlushNetDormancy();
+}
+
+void UOGInteractableComponent_Base::OnRep_NetState()
+{
+	OnNetStateChanged.Broadcast(NetState);
+}
+
+bool UOGInteractableComponent_Base::BeginPredictedInteraction(AActor* Interactor, const FGameplayTag& InputAction)
+{
+	if (NumPendingPredictions++ == 0)
+	{
+		bDisabledPredicted = false;
+	}
+
+	if (!PredictInteraction(Interactor, InputAction))
+	{
+		--NumPendingPredictions;
+		return false;
+	}
+
+	// Conveys the predicted outcome now, rather than after the round trip
+	InvalidateUIStateCache();
+	TriggerUIStateDefaultRefresh();
+	return true;
+}
+
+void UOGInteractableComponent_Base::EndPredictedInteraction(AActor* Interactor, const FGameplayTag& InputAction, bool bConfirmed)
+{
+	NumPendingPredictions = FMath::Max(NumPendingPredictions - 1, 0);
+	if (!bConfirmed)
+	{
+		RollbackInteraction(Interactor, InputAction);
+
+		// Any other pending prediction is rolled back with it, the server state replicates over whatever it confirms
+		if (bDisabledPredicted && bDisabled != bLastServerDisabled)
+		{
+			bDisabled = bLastServerDisabled;
+			HandleDisabledChanged();
+		}
+		bDisabledPredicted = false;
+
+		InvalidateUIStateCache();
+		TriggerUIStateDefaultRefresh();
+	}
+
+	if (NumPendingPredictions == 0)
+	{
+		bDisabledPredicted = false;
+	}
+}
+
+void UOGInteractableComponent_Base::PredictDisabled(bool bInDisabled)
+{
+	if (!ensureAlwaysMsgf(NumPendingPredictions > 0, TEXT("UOGInteractableComponent_Base::PredictDisabled - %s isn't predicting an interaction, use SetDisabled"), *ComponentId.ToString()))
+		return;
+	if (bInDisabled == bDisabled)
+		return;
+
+	bDisabled = bInDisabled;
+	bDisabledPredicted = true;
+	HandleDisabledChanged();
 }
 
 void UOGInteractableComponent_Base::Initialize(FName Id, UShapeComponent* InQueryVolume, UMeshComponent* InPhysicalRepresentation,
 	const FOGInteractableComponent_VisualDelegates& VisualDelegates
 ) {
+	auto* Registry = UOGInteractableRegistrySubsystem::Get(this);
+	if (Registry)
+	{
+		// Re-initializing may change the query target, so drop the previous one first
+		Registry->UnregisterInteractable(this, GetQueryTarget());
+	}
+
 	// These are initialized via inputs always
 	QueryVolume = InQueryVolume;
 	PhysicalRepresentation = InPhysicalRepresentation;
 
 	ComponentId = Id;
-	const FString IdPrefix = OccamsGamkit::Interactions::InteractableComponent::ComponentId.GetTag().GetTagName().ToString();
-	const FString IdString = FString::Printf(TEXT("%s_%s"), *IdPrefix, *Id.ToString());
-	const FName IdToUse = FName(*IdString);
-	ComponentTags.AddUnique(IdToUse);
+	AcquireHandle();
 	
 	// We only set one of the two to be queryable
 	if (InQueryVolume)
@@ -43,7 +247,6 @@ void UOGInteractableComponent_Base::Initialize(FName Id, UShapeComponent* InQuer
 		QueryVolume->SetCollisionResponseToChannel(OG_ECC_INTERACTABLE, ECR_Block);
 
 		QueryVolume->ComponentTags.Add(OccamsGamkit::Interactions::InteractableComponent::QueryVolume.GetTag().GetTagName());
-		QueryVolume->ComponentTags.AddUnique(IdToUse);
 
 		if (PhysicalRepresentation)
 		{
@@ -55,24 +258,37 @@ void UOGInteractableComponent_Base::Initialize(FName Id, UShapeComponent* InQuer
 		PhysicalRepresentation->SetCollisionResponseToChannel(OG_ECC_INTERACTABLE, ECR_Block);
 		
 		PhysicalRepresentation->ComponentTags.Add(OccamsGamkit::Interactions::InteractableComponent::QueryVolume.GetTag().GetTagName());
-		PhysicalRepresentation->ComponentTags.AddUnique(IdToUse);
 	}
 
 	ensureAlwaysMsgf(QueryVolume || PhysicalRepresentation, TEXT("UOGInteractableComponent_Base::Initialize - Needs either a volume or a mesh"));
 
-	/*
-	 * TODO: Only raycast has been implemented
-	 * The handlers for these exist to call into the same Hover functions
-	 * The Raycast implementation directly calls Hover/EndHover from the InteractorComponent
-
-	if (InteractionTriggerType == InteractionSystem::InteractionTrigger::PawnOverlap())
+	if (Registry)
 	{
+		Registry->RegisterInteractable(this, GetQueryTarget());
 	}
-	else if (InteractionTriggerType == InteractionSystem::InteractionTrigger::MouseOver())
+
+	/*
+	 * Raycast directly calls Hover/EndHover from the InteractorComponent.
+	 * PawnOverlap feeds the overlap set of the overlapping pawn's InteractorComponent, which picks its candidate.
+	 * TODO: MouseOver has not been implemented, the cursor handlers exist to call into the same Hover functions
+
+	if (InteractionTriggerType == InteractionSystem::InteractionTrigger::MouseOver())
 	{
 		// https://forums.unrealengine.com/t/use-box-collision-with-cursor-over/375072/2
 	}
 	*/
+	if (InteractionTriggerType == OccamsGamkit::Interactions::PawnOverlap)
+	{
+		// Overlapping a mesh would also mean walking through it, so overlap requires a dedicated volume
+		if (ensureAlwaysMsgf(QueryVolume, TEXT("UOGInteractableComponent_Base::Initialize - PawnOverlap on %s needs a QueryVolume"), *GetNameSafe(GetOwner())))
+		{
+			QueryVolume->SetGenerateOverlapEvents(true);
+			QueryVolume->SetCollisionResponseToChannel(ECC_Pawn, bDisabled ? ECR_Ignore : ECR_Overlap);
+			QueryVolume->OnComponentBeginOverlap.AddUniqueDynamic(this, &UOGInteractableComponent_Base::HandleOverlapBegin);
+			QueryVolume->OnComponentEndOverlap.AddUniqueDynamic(this, &UOGInteractableComponent_Base::HandleOverlapEnd);
+		}
+	}
+
 	InitializeDelegates(
 		VisualDelegates.OnDisabledChanged,
 		VisualDelegates.OnUIStateChanged,
@@ -81,7 +297,7 @@ void UOGInteractableComponent_Base::Initialize(FName Id, UShapeComponent* InQuer
 		VisualDelegates.GetUIState_DefaultState
 	);
 
-	if (GetDefaultStateDelegate.IsBound() && OnUIStateChangedDelegate.IsBound())
+	if (CanRefreshDefaultUIState())
 	{
 		TriggerUIStateDefaultRefresh();
 	}
@@ -143,50 +359,160 @@ void UOGInteractableComponent_Base::SetDisabled_Implementation(bool bInDisabled)
 	if (bInDisabled == bDisabled)
 		return;
 
+	FlushOwnerDormancy();
 	bDisabled = bInDisabled;
+	bLastServerDisabled = bInDisabled;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UOGInteractableComponent_Base, bDisabled, this);
+	if (auto* Manager = StateManager.Get())
+	{
+		Manager->MarkInteractableDirty(this);
+	}
 	if (GetOwnerRole() == ROLE_Authority)
 	{
-		OnRep_OnDisabledChanged();
+		HandleDisabledChanged();
 	}
 }
 
 FGameplayTag UOGInteractableComponent_Base::GetHoverStateFor(const AActor* Interactor) const
 {
-	return TryExecuteGetterDelegate(OnHoverDelegate, Interactor, "OnHover");
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_GetUIState);
+
+	return GetCachedUIState(EUIStateQuery::Hover, Interactor, [this, Interactor]()
+	{
+		if (!GetHandlers().HasOnHover())
+		{
+			if (const UOGInteractableConveyanceProfile* Profile = GetConveyanceProfile())
+			{
+				return Profile->GetHoverState(this, Interactor);
+			}
+		}
+		return TryExecuteGetterDelegate(GetHandlers().OnHoverNative, GetHandlers().OnHover, Interactor, TEXT("OnHover"));
+	});
 }
 
 void UOGInteractableComponent_Base::SetOnHoverDelegate(const FGetUIStateDelegate& GetUIState_OnHover)
 {
-	OnHoverDelegate = GetUIState_OnHover;
+	GetOrAddHandlers().OnHover = GetUIState_OnHover;
+	InvalidateUIStateCache();
 }
 
 FGameplayTag UOGInteractableComponent_Base::GetFocusStateFor(const AActor* Interactor) const
 {
-	return TryExecuteGetterDelegate(OnFocusDelegate, Interactor, "OnFocus");
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_GetUIState);
+
+	return GetCachedUIState(EUIStateQuery::Focus, Interactor, [this, Interactor]()
+	{
+		if (!GetHandlers().HasOnFocus())
+		{
+			if (const UOGInteractableConveyanceProfile* Profile = GetConveyanceProfile())
+			{
+				return Profile->GetFocusState(this, Interactor);
+			}
+		}
+		return TryExecuteGetterDelegate(GetHandlers().OnFocusNative, GetHandlers().OnFocus, Interactor, TEXT("OnFocus"));
+	});
 }
 void UOGInteractableComponent_Base::SetOnFocusDelegate(const FGetUIStateDelegate& GetUIState_OnFocus)
 {
-	OnFocusDelegate = GetUIState_OnFocus;
+	GetOrAddHandlers().OnFocus = GetUIState_OnFocus;
+	InvalidateUIStateCache();
 }
 
 FGameplayTag UOGInteractableComponent_Base::GetDefaultStateForLocalPlayer() const
 {
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_GetUIState);
+
 	const auto* LocalPC = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
-	return TryExecuteGetterDelegate(GetDefaultStateDelegate, LocalPC ? LocalPC->GetPawn() : nullptr, "GetDefaultState");
+	const AActor* LocalPawn = LocalPC ? LocalPC->GetPawn() : nullptr;
+	return GetCachedUIState(EUIStateQuery::Default, LocalPawn, [this, LocalPawn]()
+	{
+		if (!GetHandlers().HasGetDefaultState())
+		{
+			if (const UOGInteractableConveyanceProfile* Profile = GetConveyanceProfile())
+			{
+				return Profile->GetDefaultState(this, LocalPawn);
+			}
+		}
+		return TryExecuteGetterDelegate(GetHandlers().GetDefaultStateNative, GetHandlers().GetDefaultState, LocalPawn, TEXT("GetDefaultState"));
+	});
 }
 void UOGInteractableComponent_Base::SetGetDefaultStateDelegate(const FGetUIStateDelegate& GetUIState_DefaultState)
 {
-	GetDefaultStateDelegate = GetUIState_DefaultState;
+	GetOrAddHandlers().GetDefaultState = GetUIState_DefaultState;
+	InvalidateUIStateCache();
+}
+
+FGameplayTag UOGInteractableComponent_Base::GetCachedUIState(EUIStateQuery Query, const AActor* Interactor, TFunctionRef<FGameplayTag()> Evaluate) const
+{
+	if (!bCacheUIStates)
+		return Evaluate();
+
+	const auto* Conveyance = UOGInteractionConveyanceSubsystem::Get(this);
+	const uint32 DependencyVersion = Conveyance ? Conveyance->GetUIStateDependencyVersion(UIStateDependencies) : 0;
+	if (CachedUIStatesVersion != UIStateCacheVersion || CachedUIStatesDependencyVersion != DependencyVersion)
+	{
+		CachedUIStates.Reset();
+		CachedUIStatesVersion = UIStateCacheVersion;
+		CachedUIStatesDependencyVersion = DependencyVersion;
+	}
+
+	const FUIStateCacheKey Key{ TObjectKey<AActor>(Interactor), GetUIStateCacheItem(), Query };
+	if (const FGameplayTag* Cached = CachedUIStates.Find(Key))
+	{
+		INC_DWORD_STAT(STAT_OGInteractions_UIStateCacheHits);
+		return *Cached;
+	}
+
+	INC_DWORD_STAT(STAT_OGInteractions_UIStateCacheMisses);
+	// Evaluated before it is added, an invalidation from within Evaluate still applies to the next lookup
+	const FGameplayTag State = Evaluate();
+	if (CachedUIStatesVersion == UIStateCacheVersion)
+	{
+		CachedUIStates.Add(Key, State);
+	}
+	return State;
+}
+
+void UOGInteractableComponent_Base::SetConveyanceProfile(TSubclassOf<UOGInteractableConveyanceProfile> InConveyanceProfile)
+{
+	ConveyanceProfile = InConveyanceProfile;
+	InvalidateUIStateCache();
+}
+
+const UOGInteractableConveyanceProfile* UOGInteractableComponent_Base::GetConveyanceProfile() const
+{
+	return ConveyanceProfile ? ConveyanceProfile->GetDefaultObject<UOGInteractableConveyanceProfile>() : nullptr;
 }
 
 void UOGInteractableComponent_Base::SetOnUIStateChangedDelegate(const FOnUIStateChangedDelegate& OnUIStateChanged)
 {
-	OnUIStateChangedDelegate = OnUIStateChanged;
+	GetOrAddHandlers().OnUIStateChanged = OnUIStateChanged;
 }
 
 void UOGInteractableComponent_Base::SetOnDisabledChangedDelegate(const FOnChangeStateNotificationDelegate& OnDisabledChanged)
 {
-	OnDisabledChangedDelegate = OnDisabledChanged;
+	GetOrAddHandlers().OnDisabledChanged = OnDisabledChanged;
+}
+
+const FOGInteractableHandlers& UOGInteractableComponent_Base::GetHandlers() const
+{
+	static const FOGInteractableHandlers NoHandlers;
+	return Handlers ? *Handlers : NoHandlers;
+}
+
+FOGInteractableHandlers& UOGInteractableComponent_Base::GetOrAddHandlers()
+{
+	if (!Handlers)
+	{
+		Handlers = MakeUnique<FOGInteractableHandlers>();
+	}
+	return *Handlers;
+}
+
+UPrimitiveComponent* UOGInteractableComponent_Base::GetQueryTarget() const
+{
+	if (QueryVolume) { return QueryVolume; }
+	return PhysicalRepresentation;
 }
 
 const FGameplayTag& UOGInteractableComponent_Base::SetUIState(const FGameplayTag& NewState)
@@ -194,7 +520,23 @@ const FGameplayTag& UOGInteractableComponent_Base::SetUIState(const FGameplayTag
 	if (UIState != NewState)
 	{
 		UIState = NewState;
-		OnUIStateChange();
+
+		if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+		{
+			Registry->RecordStateTransition();
+		}
+
+		UOGInteractionConveyanceSubsystem* Conveyance = UOGInteractionConveyanceSubsystem::IsCoalescingUIStateChanges()
+			? UOGInteractionConveyanceSubsystem::Get(this)
+			: nullptr;
+		if (Conveyance)
+		{
+			Conveyance->QueueUIStateChange(this);
+		}
+		else
+		{
+			DispatchUIStateChange();
+		}
 	}
 	return UIState;
 }
@@ -204,17 +546,24 @@ const FGameplayTag& UOGInteractableComponent_Base::SetUIState(const FGameplayTag
 
 void UOGInteractableComponent_Base::HandleOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	// Only count the pawn's root, so a capsule and mesh overlapping together register once
+	if (!OtherActor || OtherComp != OtherActor->GetRootComponent() || !OtherActor->Implements<UOGInteractorInterface>())
+		return;
+
 	if (auto* AsInteractor = UOGInteractions_FunctionLibrary::GetInteractorComponent(OtherActor))
 	{
-		AsInteractor->SetInteractionCandidate(this);
+		AsInteractor->AddOverlapCandidate(this);
 	}
 }
 
 void UOGInteractableComponent_Base::HandleOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
+	if (!OtherActor || OtherComp != OtherActor->GetRootComponent() || !OtherActor->Implements<UOGInteractorInterface>())
+		return;
+
 	if (auto* AsInteractor = UOGInteractions_FunctionLibrary::GetInteractorComponent(OtherActor))
 	{
-		AsInteractor->RemoveInteractionCandidate(this);
+		AsInteractor->RemoveOverlapCandidate(this);
 	}
 }
 
@@ -234,11 +583,33 @@ void UOGInteractableComponent_Base::HandleCursorOverEnd(UPrimitiveComponent* Tou
 	}
 }
 
+void UOGInteractableComponent_Base::DispatchUIStateChange()
+{
+	BroadcastUIState = UIState;
+	OnUIStateChange();
+}
+
 void UOGInteractableComponent_Base::OnUIStateChange() const
 {
-	if (ensureAlwaysMsgf(OnUIStateChangedDelegate.IsBound(), TEXT("UOGInteractableComponent_Base::OnUIStateChange - Delegate for %s on %s has not been set"), *GetNameSafe(this), *GetNameSafe(GetOwner())))
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_OnUIStateChange);
+
+	const FOGInteractableHandlers& BoundHandlers = GetHandlers();
+	if (BoundHandlers.OnUIStateChangedNative.IsBound())
+	{
+		BoundHandlers.OnUIStateChangedNative.Execute(GetUIState());
+	}
+	else if (BoundHandlers.OnUIStateChanged.IsBound())
 	{
-		OnUIStateChangedDelegate.Execute(GetUIState());
+		BoundHandlers.OnUIStateChanged.Execute(GetUIState());
+	}
+	else if (const UOGInteractableConveyanceProfile* Profile = GetConveyanceProfile())
+	{
+		// Profiles are shared, so they are handed the Interactable to convey on
+		Profile->OnUIStateChanged(const_cast<UOGInteractableComponent_Base*>(this), GetUIState());
+	}
+	else
+	{
+		ensureAlwaysMsgf(false, TEXT("UOGInteractableComponent_Base::OnUIStateChange - Delegate for %s on %s has not been set"), *GetNameSafe(this), *GetNameSafe(GetOwner()));
 	}
 }
 
@@ -248,24 +619,47 @@ void UOGInteractableComponent_Base::OnUIStateChange() const
 ////////////////////////////////////////
 //// Begin Helpers
 	
-FGameplayTag UOGInteractableComponent_Base::TryExecuteGetterDelegate(const FGetUIStateDelegate& InDelegate, const AActor* Interactor, FString CallingFunction) const
+FGameplayTag UOGInteractableComponent_Base::TryExecuteGetterDelegate(const FGetUIStateDelegate& InDelegate, const AActor* Interactor, const TCHAR* CallingFunction) const
 {
-	if (ensureAlwaysMsgf(InDelegate.IsBound(), TEXT("UOGInteractableComponent_Base::GetterDelegate - %s Delegate for %s on %s has not been set"), *CallingFunction, *GetNameSafe(this), *GetNameSafe(GetOwner())))
+	if (ensureAlwaysMsgf(InDelegate.IsBound(), TEXT("UOGInteractableComponent_Base::GetterDelegate - %s Delegate for %s on %s has not been set"), CallingFunction, *GetNameSafe(this), *GetNameSafe(GetOwner())))
 	{
 		return InDelegate.Execute(Interactor);
 	}
 	return FGameplayTag::EmptyTag;
 }
 
+FGameplayTag UOGInteractableComponent_Base::TryExecuteGetterDelegate(const FGetUIStateNativeDelegate& InNativeDelegate, const FGetUIStateDelegate& InDelegate, const AActor* Interactor, const TCHAR* CallingFunction) const
+{
+	if (InNativeDelegate.IsBound())
+	{
+		return InNativeDelegate.Execute(Interactor);
+	}
+	return TryExecuteGetterDelegate(InDelegate, Interactor, CallingFunction);
+}
+
+bool UOGInteractableComponent_Base::CanRefreshDefaultUIState() const
+{
+	const bool bHasProfile = GetConveyanceProfile() != nullptr;
+	return (GetHandlers().HasGetDefaultState() || bHasProfile) && (GetHandlers().HasOnUIStateChanged() || bHasProfile);
+}
+
 
 void UOGInteractableComponent_Base::OnRep_OnDisabledChanged()
+{
+	bLastServerDisabled = bDisabled;
+	HandleDisabledChanged();
+}
+
+void UOGInteractableComponent_Base::HandleDisabledChanged()
 {
 	WhenInitialized->WeakThen(this, [this]()
 	{
-		UPrimitiveComponent* InteractionQueryTarget = QueryVolume;
-		if (!InteractionQueryTarget) { InteractionQueryTarget = PhysicalRepresentation; }
+		OG_INTERACTIONS_SCOPE(STAT_OGInteractions_OnRepDisabledChanged);
 
-		if (InteractionQueryTarget)
+		// The getters may read bDisabled
+		InvalidateUIStateCache();
+
+		if (UPrimitiveComponent* InteractionQueryTarget = GetQueryTarget())
 		{
 			if (bDisabled)
 			{
@@ -275,11 +669,26 @@ void UOGInteractableComponent_Base::OnRep_OnDisabledChanged()
 			{
 				InteractionQueryTarget->SetCollisionResponseToChannel(OG_ECC_INTERACTABLE, ECR_Block);
 			}
+
+			// Dropping the pawn overlap ends any current overlaps, which removes this from their overlap sets
+			if (InteractionTriggerType == OccamsGamkit::Interactions::PawnOverlap && InteractionQueryTarget == QueryVolume)
+			{
+				InteractionQueryTarget->SetCollisionResponseToChannel(ECC_Pawn, bDisabled ? ECR_Ignore : ECR_Overlap);
+			}
+		}
+
+		if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+		{
+			Registry->NotifyInteractableChanged(this);
 		}
 
-		if (OnDisabledChangedDelegate.IsBound())
+		if (GetHandlers().OnDisabledChanged.IsBound())
+		{
+			GetHandlers().OnDisabledChanged.Execute(bDisabled);
+		}
+		else if (const UOGInteractableConveyanceProfile* Profile = GetConveyanceProfile())
 		{
-			OnDisabledChangedDelegate.Execute(bDisabled);
+			Profile->OnDisabledChanged(this, bDisabled);
 		}
 		TriggerUIStateDefaultRefresh();
 	});
@@ -3,16 +3,90 @@
 
 #include "Interactable/OGInteractableComponent_BehaviorSet.h"
 
-bool FOGInteractableComponent_BehaviorSet_Base::TryExecuteDelegate_CanInteract(AActor* Interactor) const
+#include "GameplayTagAssetInterface.h"
+#include "Subsystems/OGInteractionConveyanceSubsystem.h"
+#include "Utilities/OGInteractions_Stats.h"
+
+namespace OGInteractableBehaviorSet
 {
-	if (ensureAlwaysMsgf(CanInteractDelegate.IsBound(), TEXT("FOGInteractableComponent_BehaviorSet_Base::TryExecuteDelegate_CanInteract - Delegate for %s has not been set"), *AssociatedComponentId.ToString()))
+	// Reused for every check, so once it has grown to an interactor's tag count reading them doesn't allocate. Game thread only
+	static const FGameplayTagContainer& GetOwnedTags(const AActor* Interactor)
+	{
+		static FGameplayTagContainer OwnedTags;
+		OwnedTags.Reset(OwnedTags.Num());
+		if (const auto* TagInterface = Cast<IGameplayTagAssetInterface>(Interactor))
+		{
+			TagInterface->GetOwnedGameplayTags(OwnedTags);
+		}
+		return OwnedTags;
+	}
+
+	// Order independent, owned tags aren't guaranteed to come back in the same order. Unlike operator==, doesn't build a filtered copy
+	static bool AreSameTags(const FGameplayTagContainer& A, const FGameplayTagContainer& B)
 	{
+		return A.Num() == B.Num() && A.HasAllExact(B);
+	}
+}
+
+bool FOGInteractableComponent_BehaviorSet_Base::TryExecuteDelegate_CanInteract(AActor* Interactor) const
+{
+	if (!ensureAlwaysMsgf(CanInteractDelegate.IsBound(), TEXT("FOGInteractableComponent_BehaviorSet_Base::TryExecuteDelegate_CanInteract - Delegate for %s has not been set"), *AssociatedComponentId.ToString()))
+		return false;
+
+	if (!bCacheCanInteract)
 		return CanInteractDelegate.Execute(Interactor);
+
+	if (CachedCanInteractVersion != CanInteractCacheVersion)
+	{
+		// Drops destroyed interactors' entries along with everything else
+		CachedCanInteract.Reset();
+		CachedCanInteractVersion = CanInteractCacheVersion;
+		CachedCanInteractPruneAt = 16;
+	}
+
+	const auto* Conveyance = UOGInteractionConveyanceSubsystem::Get(Interactor);
+	const uint32 DependencyVersion = Conveyance ? Conveyance->GetUIStateDependencyVersion(CanInteractDependencies) : 0;
+	const FGameplayTagContainer& InteractorTags = bCanInteractDependsOnInteractorTags ? OGInteractableBehaviorSet::GetOwnedTags(Interactor) : FGameplayTagContainer::EmptyContainer;
+
+	const TObjectKey<AActor> InteractorKey(Interactor);
+	if (const FCachedCanInteract* Cached = CachedCanInteract.Find(InteractorKey))
+	{
+		if (Cached->DependencyVersion == DependencyVersion && OGInteractableBehaviorSet::AreSameTags(Cached->InteractorTags, InteractorTags))
+		{
+			++CanInteractCacheHits;
+			INC_DWORD_STAT(STAT_OGInteractions_CanInteractCacheHits);
+			return Cached->bCanInteract;
+		}
+	}
+
+	++CanInteractCacheMisses;
+	INC_DWORD_STAT(STAT_OGInteractions_CanInteractCacheMisses);
+	const uint32 EvaluatedVersion = CanInteractCacheVersion;
+	// Copied out first, the delegate may check another behavior and refill the shared owned tags
+	FGameplayTagContainer EvaluatedTags = InteractorTags;
+	const bool bCanInteract = CanInteractDelegate.Execute(Interactor);
+	// Not kept if the delegate itself invalidated the cache
+	if (EvaluatedVersion == CanInteractCacheVersion)
+	{
+		if (CachedCanInteract.Num() >= CachedCanInteractPruneAt)
+		{
+			for (auto It = CachedCanInteract.CreateIterator(); It; ++It)
+			{
+				if (!It.Key().ResolveObjectPtr())
+				{
+					It.RemoveCurrent();
+				}
+			}
+			CachedCanInteractPruneAt = FMath::Max(16, CachedCanInteract.Num() * 2);
+		}
+		CachedCanInteract.Add(InteractorKey, { MoveTemp(EvaluatedTags), DependencyVersion, bCanInteract });
 	}
-	return false;
+	return bCanInteract;
 }
 
 DEFINE_INTERACTION_DELEGATE_IMPLEMENTATION(FOGInteractableComponent_BehaviorSet_Triggered, Succeeded, true);
 DEFINE_INTERACTION_DELEGATE_IMPLEMENTATION(FOGInteractableComponent_BehaviorSet_Triggered, Failed, false);
+DEFINE_INTERACTION_DELEGATE_IMPLEMENTATION(FOGInteractableComponent_BehaviorSet_Triggered, Predicted, false);
+DEFINE_INTERACTION_DELEGATE_IMPLEMENTATION(FOGInteractableComponent_BehaviorSet_Triggered, RolledBack, false);
 
 
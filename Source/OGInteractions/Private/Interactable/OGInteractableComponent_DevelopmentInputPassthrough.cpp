@@ -3,6 +3,7 @@
 #include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
 
 #include "Interactable/OGInteractableComponent_BehaviorSet.h"
+#include "Utilities/OGInteractions_Stats.h"
 
 
 void UOGInteractableComponent_DevelopmentInputPassthrough::Init(FName Id, UShapeComponent* InQueryVolume, UMeshComponent* InPhysicalRepresentation, const FOGInteractableComponent_VisualDelegates& VisualDelegates)
@@ -11,20 +12,45 @@ void UOGInteractableComponent_DevelopmentInputPassthrough::Init(FName Id, UShape
 }
 
 void UOGInteractableComponent_DevelopmentInputPassthrough::TryInteract_Implementation(AActor* Interactor, const FGameplayTag& InputAction)
+{
+	HandleInteractionRequest(Interactor, InputAction);
+}
+
+bool UOGInteractableComponent_DevelopmentInputPassthrough::HandleInteractionRequest(AActor* Interactor, const FGameplayTag& InputAction)
 {
 	if (!Interactor)
-		return;
+		return false;
+
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_TryInteract);
+	const auto* TriggerBehavior = InteractBehaviors.Find(InputAction);
+	if (!TriggerBehavior)
+		return false;
+
+	if (TriggerBehavior->TryExecuteDelegate_CanInteract(Interactor))
+	{
+		TriggerBehavior->TryExecuteDelegate_OnInteract_Succeeded(Interactor);
+		return true;
+	}
+
+	TriggerBehavior->TryExecuteDelegate_OnInteract_Failed(Interactor);
+	return false;
+}
 
+bool UOGInteractableComponent_DevelopmentInputPassthrough::PredictInteraction(AActor* Interactor, const FGameplayTag& InputAction)
+{
+	const auto* TriggerBehavior = InteractBehaviors.Find(InputAction);
+	if (!Interactor || !TriggerBehavior || !TriggerBehavior->TryExecuteDelegate_CanInteract(Interactor))
+		return false;
+
+	TriggerBehavior->TryExecuteDelegate_OnInteract_Predicted(Interactor);
+	return true;
+}
+
+void UOGInteractableComponent_DevelopmentInputPassthrough::RollbackInteraction(AActor* Interactor, const FGameplayTag& InputAction)
+{
 	if (const auto* TriggerBehavior = InteractBehaviors.Find(InputAction))
 	{
-		if (TriggerBehavior->TryExecuteDelegate_CanInteract(Interactor))
-		{
-			TriggerBehavior->TryExecuteDelegate_OnInteract_Succeeded(Interactor);
-		}
-		else
-		{
-			TriggerBehavior->TryExecuteDelegate_OnInteract_Failed(Interactor);
-		}
+		TriggerBehavior->TryExecuteDelegate_OnInteract_RolledBack(Interactor);
 	}
 }
 
@@ -33,3 +59,31 @@ void UOGInteractableComponent_DevelopmentInputPassthrough::BindTriggeredAction(F
 	InteractBehaviors.Add(InputAction, TriggeredBinding);
 	TriggeredBinding.AssociatedComponentId = ComponentId;
 }
+
+bool UOGInteractableComponent_DevelopmentInputPassthrough::CanInteract(AActor* Interactor, const FGameplayTag& InputAction) const
+{
+	const auto* TriggerBehavior = InteractBehaviors.Find(InputAction);
+	return Interactor && TriggerBehavior && TriggerBehavior->TryExecuteDelegate_CanInteract(Interactor);
+}
+
+void UOGInteractableComponent_DevelopmentInputPassthrough::InvalidateCanInteract(FGameplayTag InputAction)
+{
+	for (auto& Pair : InteractBehaviors)
+	{
+		if (!InputAction.IsValid() || Pair.Key == InputAction)
+		{
+			Pair.Value.InvalidateCanInteractCache();
+		}
+	}
+}
+
+void UOGInteractableComponent_DevelopmentInputPassthrough::GetCanInteractCacheCounters(int32& OutHits, int32& OutMisses) const
+{
+	OutHits = 0;
+	OutMisses = 0;
+	for (const auto& Pair : InteractBehaviors)
+	{
+		OutHits += Pair.Value.GetCanInteractCacheHits();
+		OutMisses += Pair.Value.GetCanInteractCacheMisses();
+	}
+}
@@ -0,0 +1,250 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interactable/OGInteractableComponent_Instanced.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Utilities/OGInteractions_FunctionLibrary.h"
+#include "Utilities/OGInteractions_Stats.h"
+
+void UOGInteractableComponent_Instanced::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UOGInteractableComponent_Instanced, InstanceDisabledFlags, Params);
+}
+
+void UOGInteractableComponent_Instanced::InitializeInstanced(FName Id, UInstancedStaticMeshComponent* InInstances, const FOGInteractableComponent_VisualDelegates& VisualDelegates)
+{
+	ensureAlwaysMsgf(InInstances, TEXT("UOGInteractableComponent_Instanced::InitializeInstanced - Needs instances on %s"), *GetNameSafe(GetOwner()));
+	Initialize(Id, nullptr, InInstances, VisualDelegates);
+}
+
+UInstancedStaticMeshComponent* UOGInteractableComponent_Instanced::GetInstances() const
+{
+	return Cast<UInstancedStaticMeshComponent>(PhysicalRepresentation);
+}
+
+void UOGInteractableComponent_Instanced::SetInstanceDisabled_Implementation(int32 InstanceIndex, bool bInDisabled)
+{
+	if (InstanceIndex < 0 || GetIsInstanceDisabled(InstanceIndex) == bInDisabled)
+		return;
+
+	FlushOwnerDormancy();
+	if (!InstanceDisabledFlags.IsValidIndex(InstanceIndex))
+	{
+		InstanceDisabledFlags.SetNumZeroed(InstanceIndex + 1);
+	}
+	InstanceDisabledFlags[InstanceIndex] = bInDisabled ? 1 : 0;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UOGInteractableComponent_Instanced, InstanceDisabledFlags, this);
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		OnRep_InstanceDisabledFlags();
+	}
+}
+
+bool UOGInteractableComponent_Instanced::GetIsInstanceDisabled(int32 InstanceIndex) const
+{
+	return InstanceDisabledFlags.IsValidIndex(InstanceIndex) && InstanceDisabledFlags[InstanceIndex] != 0;
+}
+
+FGameplayTag UOGInteractableComponent_Instanced::GetInstanceUIState(int32 InstanceIndex) const
+{
+	return InstanceUIStates.IsValidIndex(InstanceIndex) ? InstanceUIStates[InstanceIndex] : FGameplayTag::EmptyTag;
+}
+
+void UOGInteractableComponent_Instanced::TriggerInstanceUIStateDefaultRefresh(int32 InstanceIndex)
+{
+	const auto* LocalPlayer = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
+	SetInstanceUIState(InstanceIndex, GetInstanceStateFor(InstanceIndex, LocalPlayer ? LocalPlayer->GetPawn() : nullptr));
+}
+
+void UOGInteractableComponent_Instanced::SetOnInstanceUIStateChangedDelegate(const FOnInstanceUIStateChangedDelegate& OnInstanceUIStateChanged)
+{
+	OnInstanceUIStateChangedDelegate = OnInstanceUIStateChanged;
+}
+
+void UOGInteractableComponent_Instanced::TriggerUIStateDefaultRefresh()
+{
+	SyncInstanceCount();
+
+	const auto* LocalPlayer = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
+	const auto* LocalPawn = LocalPlayer ? LocalPlayer->GetPawn() : nullptr;
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceUIStates.Num(); ++InstanceIndex)
+	{
+		SetInstanceUIState(InstanceIndex, GetInstanceStateFor(InstanceIndex, LocalPawn));
+	}
+}
+
+void UOGInteractableComponent_Instanced::TriggerHoverForItem(const AActor* InInstigator, int32 Item)
+{
+	if (Item == INDEX_NONE)
+		return;
+
+	HoveredInstance = Item;
+	SetInstanceUIState(Item, GetInstanceStateFor(Item, InInstigator));
+}
+
+void UOGInteractableComponent_Instanced::TriggerHoverEndForItem(const AActor* InInstigator, int32 Item)
+{
+	if (HoveredInstance == Item)
+	{
+		HoveredInstance = INDEX_NONE;
+	}
+	SetInstanceUIState(Item, GetInstanceStateFor(Item, InInstigator));
+}
+
+void UOGInteractableComponent_Instanced::TriggerFocusForItem(const AActor* InInstigator, int32 Item)
+{
+	if (Item == INDEX_NONE)
+		return;
+
+	FocusedInstance = Item;
+	SetInstanceUIState(Item, GetInstanceStateFor(Item, InInstigator));
+}
+
+void UOGInteractableComponent_Instanced::TriggerFocusEndForItem(const AActor* InInstigator, int32 Item)
+{
+	if (FocusedInstance == Item)
+	{
+		FocusedInstance = INDEX_NONE;
+	}
+	SetInstanceUIState(Item, GetInstanceStateFor(Item, InInstigator));
+}
+
+int32 UOGInteractableComponent_Instanced::GetInteractionItem(const FHitResult& HitResult) const
+{
+	// For instanced components the hit item is the instance index
+	return HitResult.Item;
+}
+
+bool UOGInteractableComponent_Instanced::IsItemDisabled(int32 Item) const
+{
+	return GetIsDisabled() || GetIsInstanceDisabled(Item);
+}
+
+void UOGInteractableComponent_Instanced::OnUIStateChange() const
+{
+	if (GetHandlers().HasOnUIStateChanged() || GetConveyanceProfile())
+	{
+		Super::OnUIStateChange();
+	}
+}
+
+bool UOGInteractableComponent_Instanced::CanRefreshDefaultUIState() const
+{
+	// Custom data is always available to convey to, only the getter is needed
+	return GetHandlers().HasGetDefaultState() || GetConveyanceProfile();
+}
+
+void UOGInteractableComponent_Instanced::OnRep_InstanceDisabledFlags()
+{
+	WhenInitialized->WeakThen(this, [this]()
+	{
+		const int32 NumFlags = FMath::Max(InstanceDisabledFlags.Num(), AppliedDisabledFlags.Num());
+		for (int32 InstanceIndex = 0; InstanceIndex < NumFlags; ++InstanceIndex)
+		{
+			const bool bIsDisabled = GetIsInstanceDisabled(InstanceIndex);
+			const bool bWasDisabled = AppliedDisabledFlags.IsValidIndex(InstanceIndex) && AppliedDisabledFlags[InstanceIndex] != 0;
+			if (bIsDisabled != bWasDisabled)
+			{
+				ApplyInstanceDisabled(InstanceIndex, bIsDisabled);
+			}
+		}
+		AppliedDisabledFlags = InstanceDisabledFlags;
+
+		if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+		{
+			Registry->NotifyInteractableChanged(this);
+		}
+	});
+}
+
+void UOGInteractableComponent_Instanced::SyncInstanceCount()
+{
+	const UInstancedStaticMeshComponent* Instances = GetInstances();
+	const int32 NumInstances = Instances ? Instances->GetInstanceCount() : 0;
+	if (InstanceUIStates.Num() < NumInstances)
+	{
+		InstanceUIStates.SetNum(NumInstances);
+	}
+}
+
+FGameplayTag UOGInteractableComponent_Instanced::GetInstanceStateFor(int32 InstanceIndex, const AActor* Interactor)
+{
+	TGuardValue<int32> EvaluatingGuard(EvaluatingInstance, InstanceIndex);
+
+	if (InstanceIndex == FocusedInstance)
+	{
+		return GetFocusStateFor(Interactor);
+	}
+	if (InstanceIndex == HoveredInstance)
+	{
+		return GetHoverStateFor(Interactor);
+	}
+	return GetDefaultStateForLocalPlayer();
+}
+
+void UOGInteractableComponent_Instanced::SetInstanceUIState(int32 InstanceIndex, const FGameplayTag& NewState)
+{
+	if (!InstanceUIStates.IsValidIndex(InstanceIndex))
+	{
+		// Instances may have been added since the last sync
+		SyncInstanceCount();
+		if (!InstanceUIStates.IsValidIndex(InstanceIndex))
+			return;
+	}
+	if (InstanceUIStates[InstanceIndex] == NewState)
+		return;
+
+	InstanceUIStates[InstanceIndex] = NewState;
+
+	if (auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+	{
+		Registry->RecordStateTransition();
+	}
+
+	UInstancedStaticMeshComponent* Instances = GetInstances();
+	if (Instances && UIStateCustomDataIndex != INDEX_NONE && UIStateCustomDataIndex < Instances->NumCustomDataFloats)
+	{
+		const float* CustomDataValue = UIStateCustomDataValues.Find(NewState);
+		Instances->SetCustomDataValue(InstanceIndex, UIStateCustomDataIndex, CustomDataValue ? *CustomDataValue : 0.f, true);
+	}
+
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_OnUIStateChange);
+	if (OnInstanceUIStateChangedDelegate.IsBound())
+	{
+		OnInstanceUIStateChangedDelegate.Execute(InstanceIndex, NewState);
+	}
+}
+
+void UOGInteractableComponent_Instanced::ApplyInstanceDisabled(int32 InstanceIndex, bool bInDisabled)
+{
+	UInstancedStaticMeshComponent* Instances = GetInstances();
+	if (Instances && DisabledCustomDataIndex != INDEX_NONE && DisabledCustomDataIndex < Instances->NumCustomDataFloats)
+	{
+		Instances->SetCustomDataValue(InstanceIndex, DisabledCustomDataIndex, bInDisabled ? 1.f : 0.f, true);
+	}
+
+	// A disabled instance can't stay the local candidate
+	if (bInDisabled && HoveredInstance == InstanceIndex)
+	{
+		const auto* LocalPlayer = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
+		auto* Interactor = UOGInteractions_FunctionLibrary::GetInteractorComponent(LocalPlayer ? LocalPlayer->GetPawn() : nullptr);
+		if (Interactor && Interactor->GetInteractionCandidate() == this && Interactor->GetInteractionCandidateItem() == InstanceIndex)
+		{
+			Interactor->ClearInteractionCandidate();
+		}
+	}
+
+	// The getters may read whether the instance is disabled
+	InvalidateUIStateCache();
+	TriggerInstanceUIStateDefaultRefresh(InstanceIndex);
+}
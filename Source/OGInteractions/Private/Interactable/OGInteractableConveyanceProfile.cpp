@@ -0,0 +1,27 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interactable/OGInteractableConveyanceProfile.h"
+
+FGameplayTag UOGInteractableConveyanceProfile::GetHoverState_Implementation(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const
+{
+	return FGameplayTag::EmptyTag;
+}
+
+FGameplayTag UOGInteractableConveyanceProfile::GetFocusState_Implementation(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const
+{
+	return FGameplayTag::EmptyTag;
+}
+
+FGameplayTag UOGInteractableConveyanceProfile::GetDefaultState_Implementation(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const
+{
+	return FGameplayTag::EmptyTag;
+}
+
+void UOGInteractableConveyanceProfile::OnUIStateChanged_Implementation(UOGInteractableComponent_Base* Interactable, const FGameplayTag& NewUIState) const
+{
+}
+
+void UOGInteractableConveyanceProfile::OnDisabledChanged_Implementation(UOGInteractableComponent_Base* Interactable, bool bNewDisabled) const
+{
+}
@@ -4,83 +4,352 @@
 #include "Interactor/OGInteractorComponent.h"
 
 #include "Camera/CameraComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "Interactable/OGInteractableComponent_Base.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/ScopeExit.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Subsystems/OGInteractionQuerySubsystem.h"
+#include "TimerManager.h"
+#include "Utilities/OGInteractions_Stats.h"
 #include "Utilities/OGInteractions_Types.h"
 #include "Utilities/OGInteractionTags.h"
 
+static TAutoConsoleVariable<float> CVarOGInteractionsRequestRate(
+	TEXT("OG.Interactions.RequestRate"),
+	10.f,
+	TEXT("Interaction requests per second the server accepts from each interactor, the rest are dropped before they are resolved. 0 disables the limit."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsRequestBurst(
+	TEXT("OG.Interactions.RequestBurst"),
+	5.f,
+	TEXT("Interaction requests an interactor may send at once before OG.Interactions.RequestRate applies."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsRequestDistanceTolerance(
+	TEXT("OG.Interactions.RequestDistanceTolerance"),
+	300.f,
+	TEXT("How far (cm) past an interactor's reach the server still accepts a request, for the view's offset from the actor and movement in flight."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsPredictionTimeout(
+	TEXT("OG.Interactions.PredictionTimeout"),
+	2.f,
+	TEXT("Seconds a predicted interaction waits for the server before it is rolled back as rejected."),
+	ECVF_Default
+);
+
+#if STATS || CSV_PROFILER
+// Adds the enclosing scope's time to one of the registry's per-world timers, compiled out with the rest of the profiling
+#define OG_INTERACTIONS_RECORD_TIME(RecordFunction) \
+	const uint64 RecordStartCycles = FPlatformTime::Cycles64(); \
+	ON_SCOPE_EXIT \
+	{ \
+		if (InteractableRegistry) \
+		{ \
+			InteractableRegistry->RecordFunction(FPlatformTime::Cycles64() - RecordStartCycles); \
+		} \
+	}
+#else
+#define OG_INTERACTIONS_RECORD_TIME(RecordFunction)
+#endif
+
 
 UOGInteractorComponent::UOGInteractorComponent()
 {
 	// Only tick for Raycast Interactions
 	PrimaryComponentTick.bCanEverTick = InteractionTriggerType == OccamsGamkit::Interactions::Raycast;
+	// For ServerRequestInteractions, nothing on the component itself replicates
+	SetIsReplicatedByDefault(true);
+}
+
+void UOGInteractorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	InteractableRegistry = UOGInteractableRegistrySubsystem::Get(this);
+	AsyncTraceDelegate.BindUObject(this, &UOGInteractorComponent::HandleAsyncTraceComplete);
+
+	if (TraceMode == EOGInteractorTraceMode::InteractableBVH && InteractableRegistry)
+	{
+		InteractableRegistry->EnableInteractableBVH();
+	}
+
+	// Simple collision, ignoring our own actor
+	TraceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(OGInteractorTrace), false, GetOwner());
+
+	if (UsesOverlapCandidates())
+	{
+		// Sized for a crowded area up front, so overlap churn doesn't grow the set mid-play
+		OverlapCandidates.Reserve(16);
+
+		// PawnOverlap is event driven, the candidate only changes when the overlap set does
+		if (!bOverlapFromProximityGrid)
+		{
+			SetComponentTickEnabled(false);
+		}
+	}
+
+	// Only a ticking interactor has queries to batch.
+	// Otherwise ticks until it can, a client's own pawn may only become locally controlled after BeginPlay
+	if (bBatchedQueries && IsComponentTickEnabled())
+	{
+		TryRegisterBatchedQueries();
+	}
+
+	if ((bMotionGatedTrace || UsesOverlapCandidates()) && InteractableRegistry)
+	{
+		InteractableChangedHandle = InteractableRegistry->OnInteractableChanged.AddUObject(this, &UOGInteractorComponent::HandleInteractableChanged);
+	}
+}
+
+void UOGInteractorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FlushInteractionRequestsHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(FlushInteractionRequestsHandle);
+		FlushInteractionRequestsHandle.Reset();
+	}
+	PendingInteractionRequests.Reset();
+
+	// Nothing will answer these anymore
+	while (PendingPredictions.Num() > 0)
+	{
+		ResolvePrediction(0, false);
+	}
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(PredictionTimeoutTimer);
+	}
+
+	if (InteractableRegistry)
+	{
+		InteractableRegistry->OnInteractableChanged.Remove(InteractableChangedHandle);
+	}
+	if (auto* QuerySubsystem = UOGInteractionQuerySubsystem::Get(this))
+	{
+		QuerySubsystem->UnregisterInteractor(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UOGInteractorComponent::OnUnregister()
+{
+	// Anything still in flight belongs to a previous registration
+	PendingTraceHandle = FTraceHandle();
+	PendingTraceController.Reset();
+
+	Super::OnUnregister();
 }
 
 void UOGInteractorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Hands off to the query subsystem once there is one and this interactor should query
+	if (bBatchedQueries && TryRegisterBatchedQueries())
+		return;
+
 	// Only Raycast locally
 	auto* Owner = Cast<APawn>(GetOwner());
-	if (Owner && Owner->IsLocallyControlled())
+	if (Owner && Owner->IsLocallyControlled() && UsesOverlapCandidates())
+	{
+		OG_INTERACTIONS_RECORD_TIME(RecordInteractorTickTime);
+		RefreshProximityOverlapCandidates();
+	}
+	else if (Owner && Owner->IsLocallyControlled())
 	{
-		if (const UCameraComponent* OwnerCamera = GetOwner()->FindComponentByClass<UCameraComponent>())
+		// Steady state hovering should not allocate, anything that does shows up under this tag in memreport/Insights
+		LLM_SCOPE_BYNAME(TEXT("OGInteractions"));
+		OG_INTERACTIONS_RECORD_TIME(RecordInteractorTickTime);
+
+		if (const USceneComponent* ViewSource = GetViewSource())
 		{
-			const FVector StartTrace = OwnerCamera->GetComponentLocation();
-			const FVector EndTrace = StartTrace + (OwnerCamera->GetForwardVector() * RaycastRange);
-			FHitResult HitResult;
-			
-			if (UKismetSystemLibrary::LineTraceSingle(
-				GetWorld(), StartTrace, EndTrace, UEngineTypes::ConvertToTraceType(OG_ECC_INTERACTABLE), false, {},
-				EDrawDebugTrace::None, HitResult, true
-			))
+			const FVector StartTrace = ViewSource->GetComponentLocation();
+			const FVector ViewDirection = ViewSource->GetForwardVector();
+			if (bMotionGatedTrace)
 			{
-				if (HitResult.Component->ComponentHasTag(OccamsGamkit::Interactions::InteractableComponent::QueryVolume.GetTag().GetTagName()))
-				{
-					// If a component is tagged with the QueryVolume tag, as above, it should also have an ID tag.
-					auto IdTag = HitResult.Component->ComponentTags.FindByPredicate([](FName Tag)
-					{
-						return Tag.ToString().StartsWith(OccamsGamkit::Interactions::InteractableComponent::ComponentId.GetTag().ToString());
-					});
-
-					if (IdTag)
-					{
-						auto FoundComps = HitResult.GetActor()->GetComponentsByTag(UOGInteractableComponent_Base::StaticClass(), *IdTag);
-						
-						if (UOGInteractableComponent_Base* AsInteractableComp = FoundComps.IsValidIndex(0)
-							? Cast<UOGInteractableComponent_Base>(FoundComps[0])
-							: nullptr)
-						{
-							SetInteractionCandidate(AsInteractableComp);
-						}
-					}
-				}
-				else if (InteractionCandidate)
-				{
-					// Hit result exists, and isn't interactable
-					ClearInteractionCandidate();
-				}
+				if (!ShouldTraceFrom(StartTrace, ViewDirection))
+					return;
+
+				LastTraceLocation = StartTrace;
+				LastTraceDirection = ViewDirection;
+				LastTraceTime = GetWorld()->GetTimeSeconds();
+				bTraceInvalidated = false;
+			}
+			const FVector EndTrace = StartTrace + (ViewDirection * RaycastRange);
+
+			OG_INTERACTIONS_SCOPE(STAT_OGInteractions_InteractorTrace);
+			if (InteractableRegistry)
+			{
+				InteractableRegistry->RecordTrace();
 			}
-			else if (InteractionCandidate)
+
+			if (TraceMode == EOGInteractorTraceMode::Asynchronous)
 			{
-				// No hit result
-				ClearInteractionCandidate();
+				SubmitAsyncTrace(StartTrace, EndTrace);
+				return;
 			}
+
+			FHitResult HitResult;
+			const bool bHit = TraceMode == EOGInteractorTraceMode::InteractableBVH && InteractableRegistry
+				? InteractableRegistry->RaycastInteractableBVH(StartTrace, EndTrace, HitResult)
+				: GetWorld()->LineTraceSingleByChannel(HitResult, StartTrace, EndTrace, OG_ECC_INTERACTABLE, TraceQueryParams);
+			HandleTraceResult(bHit ? &HitResult : nullptr);
+		}
+	}
+}
+
+bool UOGInteractorComponent::ShouldRunBatchedQueries() const
+{
+	const AActor* Owner = GetOwner();
+	const auto* Pawn = Cast<APawn>(Owner);
+	return Owner && (Owner->HasAuthority() || (Pawn && Pawn->IsLocallyControlled()));
+}
+
+bool UOGInteractorComponent::TryRegisterBatchedQueries()
+{
+	if (!ShouldRunBatchedQueries())
+		return false;
+
+	auto* QuerySubsystem = UOGInteractionQuerySubsystem::Get(this);
+	if (!QuerySubsystem)
+		return false;
+
+	QuerySubsystem->RegisterInteractor(this);
+	SetComponentTickEnabled(false);
+	return true;
+}
+
+bool UOGInteractorComponent::ConveysUIState() const
+{
+	const auto* Owner = Cast<APawn>(GetOwner());
+	return !Owner || (Owner->IsLocallyControlled() && Owner->IsPlayerControlled());
+}
+
+USceneComponent* UOGInteractorComponent::GetViewSource()
+{
+	if (!CachedViewSource.IsValid())
+	{
+		CachedViewSource = GetOwner()->FindComponentByClass<UCameraComponent>();
+	}
+	return CachedViewSource.Get();
+}
+
+bool UOGInteractorComponent::ShouldTraceFrom(const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	const double TimeSinceLastTrace = GetWorld()->GetTimeSeconds() - LastTraceTime;
+	if (MaxTraceRate > 0.f && TimeSinceLastTrace < 1.0 / MaxTraceRate)
+		return false;
+
+	if (bTraceInvalidated)
+		return true;
+	if (MinTraceRate > 0.f && TimeSinceLastTrace >= 1.0 / MinTraceRate)
+		return true;
+	if (FVector::DistSquared(ViewLocation, LastTraceLocation) > FMath::Square(MotionGateLocationThreshold))
+		return true;
+
+	return (ViewDirection | LastTraceDirection) < FMath::Cos(FMath::DegreesToRadians(MotionGateAngleThreshold));
+}
+
+void UOGInteractorComponent::HandleInteractableChanged(UOGInteractableComponent_Base* Interactable)
+{
+	if (UsesOverlapCandidates())
+	{
+		// A disabled interactable stays in the set until its overlap ends, but can't be picked
+		if (OverlapCandidates.Contains(Interactable))
+		{
+			SelectOverlapCandidate();
 		}
+		return;
+	}
+
+	if (bTraceInvalidated)
+		return;
+
+	// Only changes that could alter the outcome of the last trace matter
+	if (Interactable == InteractionCandidate)
+	{
+		bTraceInvalidated = true;
+	}
+	else if (const UPrimitiveComponent* QueryTarget = Interactable->GetQueryTarget())
+	{
+		const float ReachSquared = FMath::Square(RaycastRange + QueryTarget->Bounds.SphereRadius);
+		bTraceInvalidated = FVector::DistSquared(QueryTarget->Bounds.Origin, LastTraceLocation) <= ReachSquared;
+	}
+}
+
+void UOGInteractorComponent::HandleTraceResult(const FHitResult* HitResult)
+{
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_ResolveHit);
+	OG_INTERACTIONS_RECORD_TIME(RecordResolveTime);
+
+	UOGInteractableComponent_Base* AsInteractableComp = HitResult && InteractableRegistry
+		? InteractableRegistry->FindInteractable(HitResult->GetComponent())
+		: nullptr;
+	const int32 Item = AsInteractableComp ? AsInteractableComp->GetInteractionItem(*HitResult) : INDEX_NONE;
+
+	if (AsInteractableComp && !AsInteractableComp->IsItemDisabled(Item))
+	{
+		SetInteractionCandidate(AsInteractableComp, Item);
+	}
+	else if (InteractionCandidate)
+	{
+		// No hit result, or the hit isn't interactable
+		ClearInteractionCandidate();
+	}
+}
+
+void UOGInteractorComponent::SubmitAsyncTrace(const FVector& StartTrace, const FVector& EndTrace)
+{
+	const auto* Owner = Cast<APawn>(GetOwner());
+	PendingTraceController = Owner ? Owner->GetController() : nullptr;
+	PendingTraceHandle = GetWorld()->AsyncLineTraceByChannel(
+		EAsyncTraceType::Single, StartTrace, EndTrace, OG_ECC_INTERACTABLE, TraceQueryParams,
+		FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate
+	);
+}
+
+void UOGInteractorComponent::HandleAsyncTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (!(TraceHandle == PendingTraceHandle))
+		return;
+
+	PendingTraceHandle = FTraceHandle();
+
+	// Discard the result if the pawn has changed hands (or stopped being ours) since the trace was submitted
+	const auto* Owner = Cast<APawn>(GetOwner());
+	if (!IsRegistered() || !Owner || !Owner->IsLocallyControlled() || Owner->GetController() != PendingTraceController.Get())
+		return;
+
+	const FHitResult* HitResult = nullptr;
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		HitResult = &TraceDatum.OutHits[0];
 	}
+	HandleTraceResult(HitResult);
 }
 
-void UOGInteractorComponent::SetInteractionFocus(UOGInteractableComponent_Base* NewInteractable)
+void UOGInteractorComponent::SetInteractionFocus(UOGInteractableComponent_Base* NewInteractable, int32 Item)
 {
-	const bool bAreSame = InteractionFocus == NewInteractable;
-	if (InteractionFocus && !bAreSame)
+	const bool bAreSame = InteractionFocus == NewInteractable && InteractionFocusItem == Item;
+	const bool bConveys = ConveysUIState();
+	if (InteractionFocus && !bAreSame && bConveys)
 	{
-		InteractionFocus->TriggerFocusEnd(GetOwner());
+		InteractionFocus->TriggerFocusEndForItem(GetOwner(), InteractionFocusItem);
 	}
 	if (!bAreSame)
 	{
 		InteractionFocus = NewInteractable;
-		InteractionFocus->TriggerFocus(GetOwner());
+		InteractionFocusItem = NewInteractable ? Item : INDEX_NONE;
+		if (InteractionFocus && bConveys)
+		{
+			InteractionFocus->TriggerFocusForItem(GetOwner(), InteractionFocusItem);
+		}
 	}
 }
 
@@ -88,8 +357,7 @@ void UOGInteractorComponent::RemoveInteractionFocus(UOGInteractableComponent_Bas
 {
 	if (InteractionFocus == OldInteractable)
 	{
-		InteractionFocus->TriggerFocusEnd(GetOwner());
-		InteractionFocus = nullptr;
+		ClearInteractionFocus();
 	}
 }
 
@@ -102,25 +370,31 @@ void UOGInteractorComponent::ClearInteractionFocus()
 {
 	if (InteractionFocus)
 	{
-		InteractionFocus->TriggerFocusEnd(GetOwner());
+		if (ConveysUIState())
+		{
+			InteractionFocus->TriggerFocusEndForItem(GetOwner(), InteractionFocusItem);
+		}
 		InteractionFocus = nullptr;
+		InteractionFocusItem = INDEX_NONE;
 	}
 }
 
-void UOGInteractorComponent::SetInteractionCandidate(UOGInteractableComponent_Base* NewInteractable)
+void UOGInteractorComponent::SetInteractionCandidate(UOGInteractableComponent_Base* NewInteractable, int32 Item)
 {
-	const bool bAreSame = InteractionCandidate == NewInteractable;
-	const bool bIsFocused = NewInteractable == InteractionFocus;
-	if (InteractionCandidate && !bAreSame && !bIsFocused)
+	const bool bAreSame = InteractionCandidate == NewInteractable && InteractionCandidateItem == Item;
+	const bool bIsFocused = NewInteractable == InteractionFocus && Item == InteractionFocusItem;
+	const bool bConveys = ConveysUIState();
+	if (InteractionCandidate && !bAreSame && !bIsFocused && bConveys)
 	{
-		InteractionCandidate->TriggerHoverEnd(GetOwner());
+		InteractionCandidate->TriggerHoverEndForItem(GetOwner(), InteractionCandidateItem);
 	}
 	if (!bAreSame)
 	{
 		InteractionCandidate = NewInteractable;
-		if (!bIsFocused)
+		InteractionCandidateItem = NewInteractable ? Item : INDEX_NONE;
+		if (InteractionCandidate && !bIsFocused && bConveys)
 		{
-			InteractionCandidate->TriggerHover(GetOwner());
+			InteractionCandidate->TriggerHoverForItem(GetOwner(), InteractionCandidateItem);
 		}
 	}
 }
@@ -129,11 +403,7 @@ void UOGInteractorComponent::RemoveInteractionCandidate(UOGInteractableComponent
 {
 	if (InteractionCandidate == OldInteractable)
 	{
-		if (InteractionCandidate != InteractionFocus)
-		{
-			InteractionCandidate->TriggerHoverEnd(GetOwner());
-		}
-		InteractionCandidate = nullptr;
+		ClearInteractionCandidate();
 	}
 }
 
@@ -146,10 +416,329 @@ void UOGInteractorComponent::ClearInteractionCandidate()
 {
 	if (InteractionCandidate)
 	{
-		if (InteractionCandidate != InteractionFocus)
+		if ((InteractionCandidate != InteractionFocus || InteractionCandidateItem != InteractionFocusItem) && ConveysUIState())
 		{
-			InteractionCandidate->TriggerHoverEnd(GetOwner());
+			InteractionCandidate->TriggerHoverEndForItem(GetOwner(), InteractionCandidateItem);
 		}
 		InteractionCandidate = nullptr;
+		InteractionCandidateItem = INDEX_NONE;
+	}
+}
+
+void UOGInteractorComponent::AddOverlapCandidate(UOGInteractableComponent_Base* Interactable)
+{
+	// Conveyance is local, only the locally controlled pawn tracks its overlaps
+	const auto* Owner = Cast<APawn>(GetOwner());
+	if (!Interactable || !Owner || !Owner->IsLocallyControlled() || bOverlapFromProximityGrid)
+		return;
+
+	if (!OverlapCandidates.Contains(Interactable))
+	{
+		OverlapCandidates.Add(Interactable);
+		SelectOverlapCandidate();
+	}
+}
+
+void UOGInteractorComponent::RemoveOverlapCandidate(UOGInteractableComponent_Base* Interactable)
+{
+	if (OverlapCandidates.Remove(Interactable) > 0 || Interactable == InteractionCandidate)
+	{
+		SelectOverlapCandidate();
+	}
+}
+
+void UOGInteractorComponent::RefreshProximityOverlapCandidates()
+{
+	if (!InteractableRegistry)
+		return;
+
+	// Disabled ones are kept in the set, like overlaps are, and skipped when picking
+	InteractableRegistry->GetInteractablesInRadius(GetOwner()->GetActorLocation(), ProximityOverlapRadius, ProximityScratch, true);
+
+	bool bChanged = ProximityScratch.Num() != OverlapCandidates.Num();
+	for (int32 i = 0; i < ProximityScratch.Num() && !bChanged; ++i)
+	{
+		bChanged = !OverlapCandidates.Contains(ProximityScratch[i]);
+	}
+	if (!bChanged)
+		return;
+
+	OverlapCandidates.Reset();
+	for (UOGInteractableComponent_Base* Interactable : ProximityScratch)
+	{
+		OverlapCandidates.Add(Interactable);
+	}
+	SelectOverlapCandidate();
+}
+
+void UOGInteractorComponent::SelectOverlapCandidate()
+{
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	GetOwner()->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+	const FVector ViewDirection = ViewRotation.Vector();
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(OverlapMaxViewAngle));
+
+	UOGInteractableComponent_Base* BestCandidate = nullptr;
+	float BestScore = TNumericLimits<float>::Max();
+	for (int32 i = OverlapCandidates.Num() - 1; i >= 0; --i)
+	{
+		UOGInteractableComponent_Base* Candidate = OverlapCandidates[i].Get();
+		if (!Candidate)
+		{
+			OverlapCandidates.RemoveAtSwap(i);
+			continue;
+		}
+		const UPrimitiveComponent* QueryTarget = Candidate->GetQueryTarget();
+		if (Candidate->GetIsDisabled() || !QueryTarget)
+			continue;
+
+		const FVector ToCandidate = QueryTarget->Bounds.Origin - ViewLocation;
+		const float Distance = ToCandidate.Size();
+		const float Dot = Distance > UE_KINDA_SMALL_NUMBER ? (ToCandidate / Distance) | ViewDirection : 1.f;
+		if (Dot < MinDot)
+			continue;
+
+		// Lower is better, facing away scales the distance up
+		const float Score = Distance * (1.f + OverlapViewAngleWeight * (1.f - Dot));
+		if (Score < BestScore)
+		{
+			BestScore = Score;
+			BestCandidate = Candidate;
+		}
+	}
+
+	if (BestCandidate)
+	{
+		SetInteractionCandidate(BestCandidate);
+	}
+	else
+	{
+		ClearInteractionCandidate();
+	}
+}
+
+void UOGInteractorComponent::RequestInteraction(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction)
+{
+	if (!Interactable)
+		return;
+
+	const FOGInteractableHandle Handle = Interactable->GetHandle();
+	if (!ensureAlwaysMsgf(Handle.IsValid() && !Handle.IsLocal(), TEXT("UOGInteractorComponent::RequestInteraction - %s has no server assigned handle, it can't be requested"), *GetNameSafe(Interactable->GetOwner())))
+		return;
+
+	FOGInteractionRequest& Request = PendingInteractionRequests.AddDefaulted_GetRef();
+	Request.Handle = Handle;
+	Request.InputAction = InputAction;
+
+	if (!FlushInteractionRequestsHandle.IsValid())
+	{
+		FlushInteractionRequestsHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UOGInteractorComponent::FlushInteractionRequests);
+	}
+}
+
+void UOGInteractorComponent::FlushInteractionRequests(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+		return;
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushInteractionRequestsHandle);
+	FlushInteractionRequestsHandle.Reset();
+
+	Swap(PendingInteractionRequests, SendingInteractionRequests);
+	if (SendingInteractionRequests.Num() > 0)
+	{
+		// Runs ProcessInteractionRequests directly when we're the server
+		ServerRequestInteractions(SendingInteractionRequests);
+	}
+	SendingInteractionRequests.Reset();
+}
+
+void UOGInteractorComponent::ServerRequestInteractions_Implementation(const TArray<FOGInteractionRequest>& Requests)
+{
+	ProcessInteractionRequests(Requests);
+}
+
+void UOGInteractorComponent::ProcessInteractionRequests(const TArray<FOGInteractionRequest>& Requests)
+{
+	// No more than a full bucket can be accepted, so anything past that is rejected without being looked at
+	int32 NumRequests = Requests.Num();
+	if (CVarOGInteractionsRequestRate.GetValueOnGameThread() > 0.f)
+	{
+		NumRequests = FMath::Min(NumRequests, FMath::Max(FMath::FloorToInt(CVarOGInteractionsRequestBurst.GetValueOnGameThread()), 1));
+		if (NumRequests < Requests.Num())
+		{
+			INC_DWORD_STAT_BY(STAT_OGInteractions_DroppedRequests, Requests.Num() - NumRequests);
+			UE_LOG(LogOccamsGamekit_Interactions, Verbose, TEXT("UOGInteractorComponent::ProcessInteractionRequests - %s sent %d requests at once, dropped %d"), *GetNameSafe(GetOwner()), Requests.Num(), Requests.Num() - NumRequests);
+		}
+	}
+
+	const FVector InteractorLocation = GetOwner()->GetActorLocation();
+	const float Reach = (UsesOverlapCandidates() ? ProximityOverlapRadius : RaycastRange) + CVarOGInteractionsRequestDistanceTolerance.GetValueOnGameThread();
+
+	// Predicted requests are all answered, in one RPC for the batch
+	TArray<FOGPredictedInteractionResult> Results;
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		const FOGInteractionRequest& Request = Requests[Index];
+
+		// Spam is dropped here, before the handle is even resolved. Once the bucket is empty the rest of the batch is too
+		if (!ConsumeRequestToken())
+		{
+			INC_DWORD_STAT_BY(STAT_OGInteractions_DroppedRequests, NumRequests - Index);
+			UE_LOG(LogOccamsGamekit_Interactions, Verbose, TEXT("UOGInteractorComponent::ProcessInteractionRequests - %s is over its request rate, dropped %d"), *GetNameSafe(GetOwner()), NumRequests - Index);
+			for (; Index < NumRequests; ++Index)
+			{
+				if (Requests[Index].PredictionId != 0)
+				{
+					Results.Add({ Requests[Index].PredictionId, false });
+				}
+			}
+			break;
+		}
+
+		auto* Interactable = InteractableRegistry ? InteractableRegistry->ResolveHandle(Request.Handle) : nullptr;
+		// Out of reach requests never get to the behavior's CanInteract
+		const UPrimitiveComponent* QueryTarget = Interactable ? Interactable->GetQueryTarget() : nullptr;
+		const bool bInReach = QueryTarget
+			&& FVector::DistSquared(QueryTarget->Bounds.Origin, InteractorLocation) <= FMath::Square(Reach + QueryTarget->Bounds.SphereRadius);
+		const bool bConfirmed = bInReach && !Interactable->GetIsDisabled() && Interactable->HandleInteractionRequest(GetOwner(), Request.InputAction);
+		if (Request.PredictionId != 0)
+		{
+			Results.Add({ Request.PredictionId, bConfirmed });
+		}
+	}
+
+	// Past the burst, after the batch's own answers so they stay in order
+	for (int32 Index = NumRequests; Index < Requests.Num(); ++Index)
+	{
+		if (Requests[Index].PredictionId != 0)
+		{
+			Results.Add({ Requests[Index].PredictionId, false });
+		}
+	}
+
+	if (Results.Num() > 0)
+	{
+		ClientResolvePredictedInteractions(Results);
+	}
+}
+
+bool UOGInteractorComponent::ConsumeRequestToken()
+{
+	const float Rate = CVarOGInteractionsRequestRate.GetValueOnGameThread();
+	if (Rate <= 0.f)
+		return true;
+
+	const double Now = GetWorld()->GetRealTimeSeconds();
+	const float Burst = FMath::Max(CVarOGInteractionsRequestBurst.GetValueOnGameThread(), 1.f);
+	RequestTokens = FMath::Min(Burst, RequestTokens + static_cast<float>(Now - LastRequestTokenTime) * Rate);
+	LastRequestTokenTime = Now;
+
+	if (RequestTokens < 1.f)
+		return false;
+
+	RequestTokens -= 1.f;
+	return true;
+}
+
+FOGFuture UOGInteractorComponent::PredictInteraction(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction)
+{
+	TOGPromise<void> WhenResolved;
+	const FOGInteractableHandle Handle = Interactable ? Interactable->GetHandle() : FOGInteractableHandle();
+	if (!Handle.IsValid() || Handle.IsLocal())
+	{
+		OnPredictedInteractionResolved.Broadcast(Interactable, InputAction, false);
+		WhenResolved->Fulfill();
+		return WhenResolved;
+	}
+
+	// The server applies the real outcome straight away, predicting it too would have SetDisabled find nothing to change
+	AActor* Owner = GetOwner();
+	const bool bPredicted = !Owner->HasAuthority();
+	if (bPredicted && !Interactable->BeginPredictedInteraction(Owner, InputAction))
+	{
+		OnPredictedInteractionResolved.Broadcast(Interactable, InputAction, false);
+		WhenResolved->Fulfill();
+		return WhenResolved;
+	}
+
+	// 0 is reserved for requests that weren't predicted
+	if (++NextPredictionId == 0)
+	{
+		++NextPredictionId;
+	}
+
+	const float Timeout = FMath::Max(CVarOGInteractionsPredictionTimeout.GetValueOnGameThread(), 0.1f);
+	FPendingPrediction& Prediction = PendingPredictions.AddDefaulted_GetRef();
+	Prediction.PredictionId = NextPredictionId;
+	Prediction.Interactable = Interactable;
+	Prediction.InputAction = InputAction;
+	Prediction.ExpireTime = GetWorld()->GetTimeSeconds() + Timeout;
+	Prediction.bPredicted = bPredicted;
+	Prediction.WhenResolved = WhenResolved;
+
+	FOGInteractionRequest& Request = PendingInteractionRequests.AddDefaulted_GetRef();
+	Request.Handle = Handle;
+	Request.InputAction = InputAction;
+	Request.PredictionId = NextPredictionId;
+
+	if (!FlushInteractionRequestsHandle.IsValid())
+	{
+		FlushInteractionRequestsHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UOGInteractorComponent::FlushInteractionRequests);
+	}
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (!TimerManager.IsTimerActive(PredictionTimeoutTimer))
+	{
+		TimerManager.SetTimer(PredictionTimeoutTimer, this, &UOGInteractorComponent::ExpirePredictions, Timeout, false);
+	}
+	return WhenResolved;
+}
+
+void UOGInteractorComponent::ClientResolvePredictedInteractions_Implementation(const TArray<FOGPredictedInteractionResult>& Results)
+{
+	for (const FOGPredictedInteractionResult& Result : Results)
+	{
+		// Not found once it has timed out, the replicated state settles it instead
+		const int32 Index = PendingPredictions.IndexOfByPredicate([&Result](const FPendingPrediction& Prediction)
+		{
+			return Prediction.PredictionId == Result.PredictionId;
+		});
+		if (Index != INDEX_NONE)
+		{
+			ResolvePrediction(Index, Result.bConfirmed);
+		}
+	}
+}
+
+void UOGInteractorComponent::ResolvePrediction(int32 Index, bool bConfirmed)
+{
+	// Out of the list first, rollback may run game code that predicts again
+	FPendingPrediction Prediction = MoveTemp(PendingPredictions[Index]);
+	PendingPredictions.RemoveAt(Index);
+
+	auto* Interactable = Prediction.Interactable.Get();
+	if (Interactable && Prediction.bPredicted)
+	{
+		Interactable->EndPredictedInteraction(GetOwner(), Prediction.InputAction, bConfirmed);
+	}
+	OnPredictedInteractionResolved.Broadcast(Interactable, Prediction.InputAction, bConfirmed);
+	Prediction.WhenResolved->Fulfill();
+}
+
+void UOGInteractorComponent::ExpirePredictions()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	while (PendingPredictions.Num() > 0 && PendingPredictions[0].ExpireTime <= Now)
+	{
+		UE_LOG(LogOccamsGamekit_Interactions, Verbose, TEXT("UOGInteractorComponent::ExpirePredictions - %s got no answer for prediction %d, rolling back"), *GetNameSafe(GetOwner()), PendingPredictions[0].PredictionId);
+		ResolvePrediction(0, false);
+	}
+
+	if (PendingPredictions.Num() > 0)
+	{
+		GetWorld()->GetTimerManager().SetTimer(PredictionTimeoutTimer, this, &UOGInteractorComponent::ExpirePredictions,
+			FMath::Max(static_cast<float>(PendingPredictions[0].ExpireTime - Now), 0.01f), false);
 	}
 }
@@ -0,0 +1,113 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Replication/OGInteractableStateManager.h"
+
+#include "Components/SceneComponent.h"
+#include "Interactable/OGInteractableComponent_Base.h"
+#include "Net/UnrealNetwork.h"
+
+void FOGInteractableStateItem::PostReplicatedAdd(const FOGInteractableStateArray& InArraySerializer)
+{
+	Apply();
+}
+
+void FOGInteractableStateItem::PostReplicatedChange(const FOGInteractableStateArray& InArraySerializer)
+{
+	Apply();
+}
+
+void FOGInteractableStateItem::Apply() const
+{
+	// Null until the Interactable's reference resolves, the fast array calls PostReplicatedChange again when it does
+	if (UOGInteractableComponent_Base* Target = Interactable.Get())
+	{
+		Target->ApplyManagedState(Handle, bDisabled, NetState);
+	}
+}
+
+AOGInteractableStateManager::AOGInteractableStateManager()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	// Cell managers are placed, and relevant, by location
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void AOGInteractableStateManager::InitializeCell(const FIntPoint& InCell, double InCellSize, double RelevancyRadius)
+{
+	Cell = InCell;
+	CellSize = InCellSize;
+	CellRelevancyRadius = RelevancyRadius;
+	bSpatial = true;
+
+	// Without a replication graph this falls back to distance relevancy, reaching the corners of the cell
+	bAlwaysRelevant = false;
+	NetCullDistanceSquared = FMath::Square(RelevancyRadius + CellSize * FMath::Sqrt(0.5));
+}
+
+void AOGInteractableStateManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AOGInteractableStateManager, States);
+}
+
+void AOGInteractableStateManager::AddInteractable(UOGInteractableComponent_Base* Interactable)
+{
+	if (!Interactable || ItemIndices.Contains(Interactable))
+		return;
+
+	FOGInteractableStateItem& Item = States.Items.AddDefaulted_GetRef();
+	Item.Interactable = Interactable;
+	Item.Handle = Interactable->GetHandle();
+	Item.bDisabled = Interactable->GetIsDisabled();
+	Item.NetState = Interactable->GetNetState();
+	ItemIndices.Add(Interactable, States.Items.Num() - 1);
+	States.MarkItemDirty(Item);
+}
+
+void AOGInteractableStateManager::RemoveInteractable(UOGInteractableComponent_Base* Interactable)
+{
+	int32 Index = INDEX_NONE;
+	if (!Interactable || !ItemIndices.RemoveAndCopyValue(Interactable, Index))
+		return;
+
+	States.Items.RemoveAtSwap(Index);
+	// The last item moved into Index, from what is now Num()
+	while (States.Items.IsValidIndex(Index))
+	{
+		if (UOGInteractableComponent_Base* Moved = States.Items[Index].Interactable.Get())
+		{
+			ItemIndices.Add(Moved, Index);
+			break;
+		}
+
+		// Its Interactable was destroyed without being removed, drop the item and its stale index too
+		const int32 StaleIndex = States.Items.Num();
+		for (auto It = ItemIndices.CreateIterator(); It; ++It)
+		{
+			if (It.Value() == StaleIndex)
+			{
+				It.RemoveCurrent();
+				break;
+			}
+		}
+		States.Items.RemoveAtSwap(Index);
+	}
+	States.MarkArrayDirty();
+}
+
+void AOGInteractableStateManager::MarkInteractableDirty(UOGInteractableComponent_Base* Interactable)
+{
+	const int32* Index = Interactable ? ItemIndices.Find(Interactable) : nullptr;
+	if (!Index)
+		return;
+
+	FOGInteractableStateItem& Item = States.Items[*Index];
+	Item.Handle = Interactable->GetHandle();
+	Item.bDisabled = Interactable->GetIsDisabled();
+	Item.NetState = Interactable->GetNetState();
+	States.MarkItemDirty(Item);
+}
@@ -0,0 +1,634 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+
+#include "Components/ShapeComponent.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Interactable/OGInteractableComponent_Base.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Replication/OGInteractableStateManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "Serialization/JsonWriter.h"
+#include "Subsystems/OGInteractionConveyanceSubsystem.h"
+#include "Utilities/OGInteractions_Stats.h"
+#include "Utilities/OGInteractions_Types.h"
+
+static TAutoConsoleVariable<float> CVarOGInteractionsProximityGridCellSize(
+	TEXT("OG.Interactions.ProximityGridCellSize"),
+	500.f,
+	TEXT("Cell size (cm) of the registry's proximity grid, read when a world starts. Roughly the radius of a typical nearby-interactable query."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsStateManagerCellSize(
+	TEXT("OG.Interactions.StateManagerCellSize"),
+	0.f,
+	TEXT("When above 0, Interactables that replicate through a state manager get one per level and grid cell of this size (cm), rather than one per level. Read when a world starts."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsStateRelevancyRadius(
+	TEXT("OG.Interactions.StateRelevancyRadius"),
+	15000.f,
+	TEXT("Cell state managers only replicate to connections viewing from within this distance (cm) of their cell."),
+	ECVF_Default
+);
+
+TRACE_DECLARE_INT_COUNTER(OGInteractions_RegisteredInteractables, TEXT("OGInteractions/RegisteredInteractables"));
+TRACE_DECLARE_INT_COUNTER(OGInteractions_TracesPerFrame, TEXT("OGInteractions/TracesPerFrame"));
+TRACE_DECLARE_INT_COUNTER(OGInteractions_StateTransitionsPerFrame, TEXT("OGInteractions/StateTransitionsPerFrame"));
+
+static FAutoConsoleCommandWithOutputDevice OGInteractionsDumpStatsCommand(
+	TEXT("OG.Interactions.DumpStats"),
+	TEXT("Prints the OGInteractions counters of every game world."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			const UWorld* World = WorldContext.World();
+			const auto* Registry = UOGInteractableRegistrySubsystem::Get(World);
+			if (!Registry)
+				continue;
+
+			const FOGInteractionsWorldStats& Stats = Registry->GetWorldStats();
+			Ar.Logf(TEXT("OGInteractions [%s]: Registered %d | Traces last frame %d, total %lld | State transitions last frame %d, total %lld"),
+				*World->GetName(), Registry->GetNumRegisteredInteractables(),
+				Stats.TracesLastFrame, Stats.TotalTraces, Stats.StateTransitionsLastFrame, Stats.TotalStateTransitions);
+
+			if (const auto* Conveyance = UOGInteractionConveyanceSubsystem::Get(World))
+			{
+				Ar.Logf(TEXT("OGInteractions [%s]: Coalesced UI state changes dispatched last frame %d | Elided last frame %d, total %lld"),
+					*World->GetName(), Conveyance->GetLastFrameDispatchedTransitionCount(),
+					Conveyance->GetLastFrameElidedTransitionCount(), Conveyance->GetElidedTransitionCount());
+				Ar.Logf(TEXT("OGInteractions [%s]: Callouts in view last frame %d | Default states refreshed last frame %d"),
+					*World->GetName(), Conveyance->GetLastFrameVisibleCalloutCount(), Conveyance->GetLastFrameCalloutRefreshCount());
+				Ar.Logf(TEXT("OGInteractions [%s]: Dirty Interactables %d | Refreshed last frame %d"),
+					*World->GetName(), Conveyance->GetNumDirtyInteractables(), Conveyance->GetLastFrameDirtyRefreshCount());
+			}
+		}
+	})
+);
+
+static FAutoConsoleCommandWithArgsAndOutputDevice OGInteractionsCaptureStatsCommand(
+	TEXT("OG.Interactions.CaptureStats"),
+	TEXT("OG.Interactions.CaptureStats [NumFrames=300] - Records the OGInteractions counters of every game world for NumFrames, then writes them as JSON to Saved/Profiling/OGInteractions."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300;
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			if (auto* Registry = UOGInteractableRegistrySubsystem::Get(WorldContext.World()))
+			{
+				Registry->StartStatsCapture(NumFrames);
+				Ar.Logf(TEXT("OGInteractions [%s]: Capturing %d frames"), *WorldContext.World()->GetName(), NumFrames);
+			}
+		}
+	})
+);
+
+UOGInteractableRegistrySubsystem* UOGInteractableRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UOGInteractableRegistrySubsystem>() : nullptr;
+}
+
+void UOGInteractableRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ProximityCellSize = FMath::Max(CVarOGInteractionsProximityGridCellSize.GetValueOnGameThread(), 1.f);
+	StateManagerCellSize = FMath::Max(CVarOGInteractionsStateManagerCellSize.GetValueOnGameThread(), 0.f);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UOGInteractableRegistrySubsystem::HandleWorldPostActorTick);
+}
+
+void UOGInteractableRegistrySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	DEC_DWORD_STAT_BY(STAT_OGInteractions_RegisteredInteractables, QueryTargetToInteractable.Num());
+
+	for (const auto& Pair : QueryTargetToInteractable)
+	{
+		if (UPrimitiveComponent* QueryTarget = Pair.Key.ResolveObjectPtr())
+		{
+			QueryTarget->TransformUpdated.Remove(Pair.Value.TransformUpdatedHandle);
+		}
+	}
+	QueryTargetToInteractable.Empty();
+	ProximityGrid.Empty();
+	OversizedProximityTargets.Empty();
+	InteractableBVH.Reset();
+	StateManagers.Empty();
+	NetworkedHandles = FHandleTable();
+	LocalHandles = FHandleTable();
+	Super::Deinitialize();
+}
+
+void UOGInteractableRegistrySubsystem::RegisterInteractable(UOGInteractableComponent_Base* Interactable, UPrimitiveComponent* QueryTarget)
+{
+	if (!Interactable || !QueryTarget)
+		return;
+
+	const TObjectKey<UPrimitiveComponent> Key(QueryTarget);
+	if (!QueryTargetToInteractable.Contains(Key))
+	{
+		INC_DWORD_STAT(STAT_OGInteractions_RegisteredInteractables);
+	}
+	FRegisteredInteractable& Entry = QueryTargetToInteractable.FindOrAdd(Key);
+	if (Entry.Interactable.IsValid() && Entry.Interactable.Get() != Interactable)
+	{
+		UE_LOG(LogOccamsGamekit_Interactions, Warning, TEXT("UOGInteractableRegistrySubsystem::RegisterInteractable - %s on %s is already the query target for %s, replacing it with %s"),
+			*GetNameSafe(QueryTarget), *GetNameSafe(QueryTarget->GetOwner()), *GetNameSafe(Entry.Interactable.Get()), *GetNameSafe(Interactable));
+	}
+	Entry.Interactable = Interactable;
+	if (!Entry.TransformUpdatedHandle.IsValid())
+	{
+		Entry.TransformUpdatedHandle = QueryTarget->TransformUpdated.AddUObject(this, &UOGInteractableRegistrySubsystem::HandleQueryTargetMoved);
+	}
+	UpdateProximityGrid(QueryTarget, Entry);
+	if (InteractableBVH)
+	{
+		InteractableBVH->AddShape(Cast<UShapeComponent>(QueryTarget), Interactable->GetIsDisabled());
+	}
+	TRACE_COUNTER_SET(OGInteractions_RegisteredInteractables, QueryTargetToInteractable.Num());
+}
+
+void UOGInteractableRegistrySubsystem::UnregisterInteractable(UOGInteractableComponent_Base* Interactable, UPrimitiveComponent* QueryTarget)
+{
+	if (!QueryTarget)
+		return;
+
+	const TObjectKey<UPrimitiveComponent> Key(QueryTarget);
+	if (FRegisteredInteractable* Entry = QueryTargetToInteractable.Find(Key))
+	{
+		// Only remove the entry if it still belongs to this Interactable, another may have been registered in its place
+		if (!Entry->Interactable.IsValid() || Entry->Interactable.Get() == Interactable)
+		{
+			QueryTarget->TransformUpdated.Remove(Entry->TransformUpdatedHandle);
+			RemoveFromProximityGrid(Key, *Entry);
+			QueryTargetToInteractable.Remove(Key);
+			if (InteractableBVH)
+			{
+				InteractableBVH->RemoveShape(QueryTarget);
+			}
+			DEC_DWORD_STAT(STAT_OGInteractions_RegisteredInteractables);
+			TRACE_COUNTER_SET(OGInteractions_RegisteredInteractables, QueryTargetToInteractable.Num());
+		}
+	}
+}
+
+UOGInteractableComponent_Base* UOGInteractableRegistrySubsystem::FindInteractable(const UPrimitiveComponent* QueryTarget) const
+{
+	if (!QueryTarget)
+		return nullptr;
+
+	const FRegisteredInteractable* Entry = QueryTargetToInteractable.Find(TObjectKey<UPrimitiveComponent>(QueryTarget));
+	return Entry ? Entry->Interactable.Get() : nullptr;
+}
+
+void UOGInteractableRegistrySubsystem::GetInteractablesInRadius(const FVector& Location, float Radius, TArray<UOGInteractableComponent_Base*>& OutInteractables, bool bIncludeDisabled) const
+{
+	OutInteractables.Reset();
+
+	auto GatherCell = [&](const auto& Cell)
+	{
+		for (const TObjectKey<UPrimitiveComponent>& Key : Cell)
+		{
+			const FRegisteredInteractable* Entry = QueryTargetToInteractable.Find(Key);
+			UOGInteractableComponent_Base* Interactable = Entry ? Entry->Interactable.Get() : nullptr;
+			const UPrimitiveComponent* QueryTarget = Key.ResolveObjectPtr();
+			if (!Interactable || !QueryTarget || (!bIncludeDisabled && Interactable->GetIsDisabled()))
+				continue;
+
+			if (FVector::Dist(QueryTarget->Bounds.Origin, Location) - QueryTarget->Bounds.SphereRadius <= Radius)
+			{
+				OutInteractables.Add(Interactable);
+			}
+		}
+	};
+
+	GatherCell(OversizedProximityTargets);
+
+	// Anything in the grid is at most half a cell across, so reaching that much further catches targets centred in a neighbouring cell
+	const FVector Reach(Radius + ProximityCellSize * 0.5);
+	const FIntVector MinCell = GetProximityCell(Location - Reach);
+	const FIntVector MaxCell = GetProximityCell(Location + Reach);
+	const int64 NumCellsInReach = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	// A radius spanning more cells than are occupied is cheaper to answer by visiting the occupied ones
+	if (NumCellsInReach > ProximityGrid.Num())
+	{
+		for (const auto& Pair : ProximityGrid)
+		{
+			GatherCell(Pair.Value);
+		}
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const auto* Cell = ProximityGrid.Find(FIntVector(X, Y, Z)))
+				{
+					GatherCell(*Cell);
+				}
+			}
+		}
+	}
+}
+
+void UOGInteractableRegistrySubsystem::ForEachInteractable(TFunctionRef<void(UOGInteractableComponent_Base& Interactable, const UPrimitiveComponent& QueryTarget)> Visitor) const
+{
+	for (const auto& Pair : QueryTargetToInteractable)
+	{
+		UOGInteractableComponent_Base* Interactable = Pair.Value.Interactable.Get();
+		const UPrimitiveComponent* QueryTarget = Pair.Key.ResolveObjectPtr();
+		if (Interactable && QueryTarget)
+		{
+			Visitor(*Interactable, *QueryTarget);
+		}
+	}
+}
+
+FIntVector UOGInteractableRegistrySubsystem::GetProximityCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / ProximityCellSize),
+		FMath::FloorToInt32(Location.Y / ProximityCellSize),
+		FMath::FloorToInt32(Location.Z / ProximityCellSize)
+	);
+}
+
+void UOGInteractableRegistrySubsystem::UpdateProximityGrid(const UPrimitiveComponent* QueryTarget, FRegisteredInteractable& Entry)
+{
+	const FIntVector Cell = GetProximityCell(QueryTarget->Bounds.Origin);
+	const bool bOversized = QueryTarget->Bounds.SphereRadius > ProximityCellSize * 0.5;
+
+	// Most moves stay within the cell, and then there is nothing to do
+	if (Entry.bInProximityGrid && Entry.bProximityOversized == bOversized && (bOversized || Entry.ProximityCell == Cell))
+		return;
+
+	const TObjectKey<UPrimitiveComponent> Key(QueryTarget);
+	RemoveFromProximityGrid(Key, Entry);
+	if (bOversized)
+	{
+		OversizedProximityTargets.Add(Key);
+	}
+	else
+	{
+		ProximityGrid.FindOrAdd(Cell).Add(Key);
+		Entry.ProximityCell = Cell;
+	}
+	Entry.bProximityOversized = bOversized;
+	Entry.bInProximityGrid = true;
+}
+
+void UOGInteractableRegistrySubsystem::RemoveFromProximityGrid(const TObjectKey<UPrimitiveComponent>& Key, FRegisteredInteractable& Entry)
+{
+	if (!Entry.bInProximityGrid)
+		return;
+
+	if (Entry.bProximityOversized)
+	{
+		OversizedProximityTargets.RemoveSingleSwap(Key);
+	}
+	else if (auto* Cell = ProximityGrid.Find(Entry.ProximityCell))
+	{
+		Cell->RemoveSingleSwap(Key);
+		if (Cell->Num() == 0)
+		{
+			ProximityGrid.Remove(Entry.ProximityCell);
+		}
+	}
+	Entry.bInProximityGrid = false;
+}
+
+FOGInteractableHandle UOGInteractableRegistrySubsystem::AllocateHandle(UOGInteractableComponent_Base* Interactable, bool bLocal)
+{
+	if (!Interactable)
+		return FOGInteractableHandle();
+
+	FHandleTable& Table = GetHandleTable(bLocal);
+	uint32 Index;
+	if (Table.FreeIndices.Num() > 0)
+	{
+		Index = Table.FreeIndices.Pop();
+	}
+	else
+	{
+		if (!ensureAlwaysMsgf(static_cast<uint32>(Table.Slots.Num()) <= FOGInteractableHandle::MaxIndex, TEXT("UOGInteractableRegistrySubsystem::AllocateHandle - Out of handles for %s"), *GetNameSafe(Interactable)))
+			return FOGInteractableHandle();
+
+		Index = Table.Slots.AddDefaulted();
+	}
+
+	FHandleSlot& Slot = Table.Slots[Index];
+	Slot.Interactable = Interactable;
+	Slot.bOccupied = true;
+	if (Slot.Generation == 0)
+	{
+		Slot.Generation = 1;
+	}
+	return FOGInteractableHandle(Index, Slot.Generation, bLocal);
+}
+
+void UOGInteractableRegistrySubsystem::BindReplicatedHandle(const FOGInteractableHandle& Handle, UOGInteractableComponent_Base* Interactable)
+{
+	if (!Handle.IsValid() || Handle.IsLocal())
+		return;
+
+	// Clients only see the handles that replicated to them, so the table is sparse and never hands out indices itself
+	FHandleTable& Table = GetHandleTable(false);
+	if (static_cast<uint32>(Table.Slots.Num()) <= Handle.GetIndex())
+	{
+		Table.Slots.SetNum(Handle.GetIndex() + 1);
+	}
+
+	FHandleSlot& Slot = Table.Slots[Handle.GetIndex()];
+	Slot.Interactable = Interactable;
+	Slot.Generation = Handle.GetGeneration();
+	Slot.bOccupied = true;
+}
+
+void UOGInteractableRegistrySubsystem::ReleaseHandle(const FOGInteractableHandle& Handle)
+{
+	if (!IsHandleValid(Handle))
+		return;
+
+	FHandleTable& Table = GetHandleTable(Handle.IsLocal());
+	FHandleSlot& Slot = Table.Slots[Handle.GetIndex()];
+	Slot.Interactable.Reset();
+	Slot.bOccupied = false;
+
+	const bool bAllocatesHandles = Handle.IsLocal() || GetWorld()->GetNetMode() != NM_Client;
+	if (bAllocatesHandles)
+	{
+		// Skip generation 0 on wrap, it marks the invalid handle
+		Slot.Generation = Slot.Generation >= FOGInteractableHandle::MaxGeneration ? 1 : Slot.Generation + 1;
+		Table.FreeIndices.Add(Handle.GetIndex());
+	}
+}
+
+bool UOGInteractableRegistrySubsystem::IsHandleValid(const FOGInteractableHandle& Handle) const
+{
+	return FindHandleSlot(Handle) != nullptr;
+}
+
+UOGInteractableComponent_Base* UOGInteractableRegistrySubsystem::ResolveHandle(const FOGInteractableHandle& Handle) const
+{
+	const FHandleSlot* Slot = FindHandleSlot(Handle);
+	return Slot ? Slot->Interactable.Get() : nullptr;
+}
+
+const UOGInteractableRegistrySubsystem::FHandleSlot* UOGInteractableRegistrySubsystem::FindHandleSlot(const FOGInteractableHandle& Handle) const
+{
+	if (!Handle.IsValid())
+		return nullptr;
+
+	const FHandleTable& Table = GetHandleTable(Handle.IsLocal());
+	const FHandleSlot* Slot = Table.Slots.IsValidIndex(Handle.GetIndex()) ? &Table.Slots[Handle.GetIndex()] : nullptr;
+	return Slot && Slot->bOccupied && Slot->Generation == Handle.GetGeneration() ? Slot : nullptr;
+}
+
+void UOGInteractableRegistrySubsystem::EnableInteractableBVH()
+{
+	if (InteractableBVH)
+		return;
+
+	InteractableBVH = MakeUnique<FOGInteractableBVH>();
+	for (const auto& Pair : QueryTargetToInteractable)
+	{
+		const UOGInteractableComponent_Base* Interactable = Pair.Value.Interactable.Get();
+		const auto* Shape = Cast<UShapeComponent>(Pair.Key.ResolveObjectPtr());
+		if (Shape && Interactable)
+		{
+			InteractableBVH->AddShape(Shape, Interactable->GetIsDisabled());
+		}
+	}
+	InteractableBVH->Rebuild();
+}
+
+bool UOGInteractableRegistrySubsystem::RaycastInteractableBVH(const FVector& Start, const FVector& End, FHitResult& OutHit)
+{
+	// Shapes added since the last rebuild are scanned linearly, the tree is rebuilt after actors tick
+	FOGInteractableBVHHit Hit;
+	if (!InteractableBVH || !InteractableBVH->Raycast(Start, End, Hit))
+		return false;
+
+	return MakeHitResult(Hit, Start, End, OutHit);
+}
+
+bool UOGInteractableRegistrySubsystem::MakeHitResult(const FOGInteractableBVHHit& Hit, const FVector& Start, const FVector& End, FHitResult& OutHit)
+{
+	UPrimitiveComponent* HitComponent = Hit.QueryTarget.ResolveObjectPtr();
+	OutHit = FHitResult(HitComponent ? HitComponent->GetOwner() : nullptr, HitComponent, Hit.Location, (Start - End).GetSafeNormal());
+	OutHit.TraceStart = Start;
+	OutHit.TraceEnd = End;
+	OutHit.Distance = Hit.Distance;
+	OutHit.Time = Hit.Distance / FVector::Dist(Start, End);
+	OutHit.bBlockingHit = HitComponent != nullptr;
+	return OutHit.bBlockingHit;
+}
+
+AOGInteractableStateManager* UOGInteractableRegistrySubsystem::FindOrSpawnStateManager(ULevel* Level, const FVector& Location)
+{
+	UWorld* World = GetWorld();
+	if (!Level || !World || World->GetNetMode() == NM_Client)
+		return nullptr;
+
+	const bool bSpatial = StateManagerCellSize > 0.0;
+	const FIntPoint Cell = bSpatial
+		? FIntPoint(FMath::FloorToInt32(Location.X / StateManagerCellSize), FMath::FloorToInt32(Location.Y / StateManagerCellSize))
+		: FIntPoint::ZeroValue;
+
+	TWeakObjectPtr<AOGInteractableStateManager>& Manager = StateManagers.FindOrAdd(MakeTuple(TObjectKey<ULevel>(Level), Cell));
+	if (!Manager.IsValid())
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.OverrideLevel = Level;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		FVector SpawnLocation = FVector::ZeroVector;
+		if (bSpatial)
+		{
+			SpawnLocation = AOGInteractableStateManager::GetCellCenter(Cell, StateManagerCellSize);
+			// Before it is added to the net driver, so a replication graph routes it as a cell manager
+			const double CellSize = StateManagerCellSize;
+			const double RelevancyRadius = CVarOGInteractionsStateRelevancyRadius.GetValueOnGameThread();
+			SpawnParameters.CustomPreSpawnInitalization = [Cell, CellSize, RelevancyRadius](AActor* Actor)
+			{
+				CastChecked<AOGInteractableStateManager>(Actor)->InitializeCell(Cell, CellSize, RelevancyRadius);
+			};
+		}
+		Manager = World->SpawnActor<AOGInteractableStateManager>(SpawnLocation, FRotator::ZeroRotator, SpawnParameters);
+	}
+	return Manager.Get();
+}
+
+void UOGInteractableRegistrySubsystem::NotifyInteractableChanged(UOGInteractableComponent_Base* Interactable)
+{
+	if (Interactable)
+	{
+		if (InteractableBVH)
+		{
+			InteractableBVH->SetShapeDisabled(Interactable->GetQueryTarget(), Interactable->GetIsDisabled());
+		}
+		OnInteractableChanged.Broadcast(Interactable);
+	}
+}
+
+void UOGInteractableRegistrySubsystem::RecordTrace()
+{
+	++WorldStats.TracesThisFrame;
+	++WorldStats.TotalTraces;
+	INC_DWORD_STAT(STAT_OGInteractions_Traces);
+	CSV_CUSTOM_STAT(OGInteractions, Traces, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void UOGInteractableRegistrySubsystem::RecordStateTransition()
+{
+	++WorldStats.StateTransitionsThisFrame;
+	++WorldStats.TotalStateTransitions;
+	INC_DWORD_STAT(STAT_OGInteractions_StateTransitions);
+	CSV_CUSTOM_STAT(OGInteractions, StateTransitions, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void UOGInteractableRegistrySubsystem::RecordInteractorTickTime(uint64 Cycles)
+{
+	WorldStats.InteractorTickCyclesThisFrame += Cycles;
+}
+
+void UOGInteractableRegistrySubsystem::RecordResolveTime(uint64 Cycles)
+{
+	WorldStats.ResolveCyclesThisFrame += Cycles;
+}
+
+void UOGInteractableRegistrySubsystem::StartStatsCapture(int32 NumFrames)
+{
+	StatsCaptureFrames.Reset(FMath::Max(NumFrames, 0));
+	StatsCaptureFramesRemaining = NumFrames;
+}
+
+void UOGInteractableRegistrySubsystem::HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld())
+		return;
+
+	WorldStats.TracesLastFrame = WorldStats.TracesThisFrame;
+	WorldStats.StateTransitionsLastFrame = WorldStats.StateTransitionsThisFrame;
+	WorldStats.InteractorTickMsLastFrame = FPlatformTime::ToMilliseconds64(WorldStats.InteractorTickCyclesThisFrame);
+	WorldStats.ResolveMsLastFrame = FPlatformTime::ToMilliseconds64(WorldStats.ResolveCyclesThisFrame);
+	WorldStats.TracesThisFrame = 0;
+	WorldStats.StateTransitionsThisFrame = 0;
+	WorldStats.InteractorTickCyclesThisFrame = 0;
+	WorldStats.ResolveCyclesThisFrame = 0;
+
+	TRACE_COUNTER_SET(OGInteractions_TracesPerFrame, WorldStats.TracesLastFrame);
+	TRACE_COUNTER_SET(OGInteractions_StateTransitionsPerFrame, WorldStats.StateTransitionsLastFrame);
+
+	// Shapes added or moved this frame go into the tree before next frame's queries
+	if (InteractableBVH && InteractableBVH->NeedsRebuild())
+	{
+		InteractableBVH->Rebuild();
+	}
+
+	if (StatsCaptureFramesRemaining > 0)
+	{
+		StatsCaptureFrames.Add({WorldStats.TracesLastFrame, WorldStats.StateTransitionsLastFrame, WorldStats.InteractorTickMsLastFrame, WorldStats.ResolveMsLastFrame});
+		if (--StatsCaptureFramesRemaining == 0)
+		{
+			WriteStatsCapture();
+		}
+	}
+}
+
+void UOGInteractableRegistrySubsystem::WriteStatsCapture()
+{
+	// Memory is sampled once at the end of the capture, the per-frame counters are summarised alongside the raw frames
+	int32 NumLiveInteractables = 0;
+	SIZE_T InteractableBytes = 0;
+	for (const auto& Pair : QueryTargetToInteractable)
+	{
+		if (const UOGInteractableComponent_Base* Interactable = Pair.Value.Interactable.Get())
+		{
+			InteractableBytes += Interactable->GetClass()->GetStructureSize() + Interactable->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			++NumLiveInteractables;
+		}
+	}
+	const SIZE_T RegistryBytes = QueryTargetToInteractable.GetAllocatedSize();
+
+	double TotalTickMs = 0.0, MaxTickMs = 0.0, TotalResolveMs = 0.0, MaxResolveMs = 0.0;
+	int64 TotalTraces = 0, TotalTransitions = 0;
+	for (const FStatsCaptureFrame& Frame : StatsCaptureFrames)
+	{
+		TotalTickMs += Frame.InteractorTickMs;
+		MaxTickMs = FMath::Max<double>(MaxTickMs, Frame.InteractorTickMs);
+		TotalResolveMs += Frame.ResolveMs;
+		MaxResolveMs = FMath::Max<double>(MaxResolveMs, Frame.ResolveMs);
+		TotalTraces += Frame.Traces;
+		TotalTransitions += Frame.StateTransitions;
+	}
+	const double NumFrames = FMath::Max(StatsCaptureFrames.Num(), 1);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("World"), GetWorld()->GetName());
+	Writer->WriteValue(TEXT("RegisteredInteractables"), NumLiveInteractables);
+	Writer->WriteValue(TEXT("BytesPerInteractable"), NumLiveInteractables > 0 ? static_cast<double>(InteractableBytes + RegistryBytes) / NumLiveInteractables : 0.0);
+	Writer->WriteValue(TEXT("RegistryBytes"), static_cast<int64>(RegistryBytes));
+	Writer->WriteValue(TEXT("NumFrames"), StatsCaptureFrames.Num());
+	Writer->WriteValue(TEXT("AvgInteractorTickMs"), TotalTickMs / NumFrames);
+	Writer->WriteValue(TEXT("MaxInteractorTickMs"), MaxTickMs);
+	Writer->WriteValue(TEXT("AvgResolveMs"), TotalResolveMs / NumFrames);
+	Writer->WriteValue(TEXT("MaxResolveMs"), MaxResolveMs);
+	Writer->WriteValue(TEXT("AvgTraces"), TotalTraces / NumFrames);
+	Writer->WriteValue(TEXT("AvgStateTransitions"), TotalTransitions / NumFrames);
+	Writer->WriteArrayStart(TEXT("Frames"));
+	for (const FStatsCaptureFrame& Frame : StatsCaptureFrames)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Traces"), Frame.Traces);
+		Writer->WriteValue(TEXT("StateTransitions"), Frame.StateTransitions);
+		Writer->WriteValue(TEXT("InteractorTickMs"), Frame.InteractorTickMs);
+		Writer->WriteValue(TEXT("ResolveMs"), Frame.ResolveMs);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString FilePath = FPaths::ProfilingDir() / TEXT("OGInteractions") / FString::Printf(TEXT("%s_%s.json"), *GetWorld()->GetName(), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Json, *FilePath))
+	{
+		UE_LOG(LogOccamsGamekit_Interactions, Log, TEXT("UOGInteractableRegistrySubsystem::WriteStatsCapture - Wrote %s"), *FilePath);
+	}
+	else
+	{
+		UE_LOG(LogOccamsGamekit_Interactions, Warning, TEXT("UOGInteractableRegistrySubsystem::WriteStatsCapture - Failed to write %s"), *FilePath);
+	}
+	StatsCaptureFrames.Empty();
+}
+
+void UOGInteractableRegistrySubsystem::HandleQueryTargetMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	const auto* QueryTarget = Cast<UPrimitiveComponent>(UpdatedComponent);
+	if (FRegisteredInteractable* Entry = QueryTarget ? QueryTargetToInteractable.Find(TObjectKey<UPrimitiveComponent>(QueryTarget)) : nullptr)
+	{
+		UpdateProximityGrid(QueryTarget, *Entry);
+	}
+	if (InteractableBVH)
+	{
+		InteractableBVH->UpdateShape(Cast<UShapeComponent>(UpdatedComponent));
+	}
+	NotifyInteractableChanged(FindInteractable(Cast<UPrimitiveComponent>(UpdatedComponent)));
+}
+
+bool UOGInteractableRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
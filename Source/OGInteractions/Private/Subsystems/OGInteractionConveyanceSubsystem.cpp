@@ -0,0 +1,457 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/OGInteractionConveyanceSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Interactable/OGInteractableComponent_Base.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "SceneManagement.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Utilities/OGInteractions_FunctionLibrary.h"
+#include "Utilities/OGInteractions_Stats.h"
+
+static TAutoConsoleVariable<bool> CVarOGInteractionsCoalesceUIStateChanges(
+	TEXT("OG.Interactions.CoalesceUIStateChanges"),
+	false,
+	TEXT("When true, Interactable UI state changes are batched and OnUIStateChanged is called once per component at the end of the frame, with its final state."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarOGInteractionsCalloutCulling(
+	TEXT("OG.Interactions.CalloutCulling"),
+	true,
+	TEXT("When true, RequestCalloutRefresh only evaluates the default UI state of Interactables in the local view, as they come into it. When false, it evaluates every Interactable immediately."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsCalloutCullDistance(
+	TEXT("OG.Interactions.CalloutCullDistance"),
+	0.f,
+	TEXT("Interactables further than this (cm) from the local view are treated as out of view by the callout pass. 0 is unlimited."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarOGInteractionsDirtyRefreshBudgetMs(
+	TEXT("OG.Interactions.DirtyRefreshBudgetMs"),
+	1.f,
+	TEXT("Milliseconds per frame spent refreshing the default UI state of Interactables marked dirty. At least one is refreshed every frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarOGInteractionsCalloutDemotionsPerFrame(
+	TEXT("OG.Interactions.CalloutDemotionsPerFrame"),
+	32,
+	TEXT("How many Interactables that left the local view the callout pass demotes to their CulledUIState per frame."),
+	ECVF_Default
+);
+
+UOGInteractionConveyanceSubsystem* UOGInteractionConveyanceSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UOGInteractionConveyanceSubsystem>() : nullptr;
+}
+
+bool UOGInteractionConveyanceSubsystem::IsCoalescingUIStateChanges()
+{
+	return CVarOGInteractionsCoalesceUIStateChanges.GetValueOnGameThread();
+}
+
+void UOGInteractionConveyanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UOGInteractionConveyanceSubsystem::HandleWorldPostActorTick);
+}
+
+void UOGInteractionConveyanceSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingUIStateChanges.Empty();
+	FlushingUIStateChanges.Empty();
+	PendingCalloutDemotions.Empty();
+	DirtyInteractables.Empty();
+	NextDirtyInteractable = 0;
+	UIStateDependencyVersions.Empty();
+
+	Super::Deinitialize();
+}
+
+void UOGInteractionConveyanceSubsystem::QueueUIStateChange(UOGInteractableComponent_Base* Interactable)
+{
+	if (!Interactable)
+		return;
+
+	if (Interactable->bUIStateChangePending)
+	{
+		// Already queued, the earlier transition is superseded by this one
+		++ElidedTransitionsThisFrame;
+		return;
+	}
+	Interactable->bUIStateChangePending = true;
+	PendingUIStateChanges.Add(Interactable);
+}
+
+void UOGInteractionConveyanceSubsystem::FlushUIStateChanges()
+{
+	Swap(PendingUIStateChanges, FlushingUIStateChanges);
+
+	int32 Dispatched = 0;
+	for (const TWeakObjectPtr<UOGInteractableComponent_Base>& WeakInteractable : FlushingUIStateChanges)
+	{
+		UOGInteractableComponent_Base* Interactable = WeakInteractable.Get();
+		if (!Interactable)
+			continue;
+
+		Interactable->bUIStateChangePending = false;
+		if (Interactable->GetUIState() != Interactable->BroadcastUIState)
+		{
+			Interactable->DispatchUIStateChange();
+			++Dispatched;
+		}
+		else
+		{
+			// Returned to what was last broadcast, e.g., Default -> Hover -> Default
+			++ElidedTransitionsThisFrame;
+		}
+	}
+	FlushingUIStateChanges.Reset();
+
+	LastFrameDispatchedTransitions = Dispatched;
+	LastFrameElidedTransitions = ElidedTransitionsThisFrame;
+	TotalElidedTransitions += ElidedTransitionsThisFrame;
+	ElidedTransitionsThisFrame = 0;
+}
+
+void UOGInteractionConveyanceSubsystem::HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld())
+		return;
+
+	if (CalloutEpoch != 0 && CVarOGInteractionsCalloutCulling.GetValueOnGameThread())
+	{
+		UpdateCalloutVisibility();
+	}
+	DrainDirtyInteractables();
+	FlushUIStateChanges();
+}
+
+void UOGInteractionConveyanceSubsystem::RequestCalloutRefresh()
+{
+	if (!CVarOGInteractionsCalloutCulling.GetValueOnGameThread())
+	{
+		if (const auto* Registry = UOGInteractableRegistrySubsystem::Get(this))
+		{
+			Registry->ForEachInteractable([](UOGInteractableComponent_Base& Interactable, const UPrimitiveComponent& QueryTarget)
+			{
+				if (Interactable.CanRefreshDefaultUIState())
+				{
+					Interactable.TriggerUIStateDefaultRefresh();
+				}
+			});
+		}
+		return;
+	}
+
+	// Every Interactable starts at 0, so skip it
+	++CalloutEpoch;
+	if (CalloutEpoch == 0)
+	{
+		++CalloutEpoch;
+	}
+}
+
+void UOGInteractionConveyanceSubsystem::UpdateCalloutVisibility()
+{
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_CalloutVisibility);
+
+	LastFrameVisibleCallouts = 0;
+	LastFrameCalloutRefreshes = 0;
+
+	const auto* Registry = UOGInteractableRegistrySubsystem::Get(this);
+	FMinimalViewInfo View;
+	FConvexVolume Frustum;
+	if (!Registry || !GetLocalView(View, Frustum))
+		return;
+
+	CalloutInteractables.Reset();
+	CalloutX.Reset();
+	CalloutY.Reset();
+	CalloutZ.Reset();
+	CalloutRadius.Reset();
+	Registry->ForEachInteractable([this](UOGInteractableComponent_Base& Interactable, const UPrimitiveComponent& QueryTarget)
+	{
+		// Nothing would change on refresh
+		if (!Interactable.CanRefreshDefaultUIState())
+			return;
+
+		CalloutInteractables.Add(&Interactable);
+		CalloutX.Add(QueryTarget.Bounds.Origin.X);
+		CalloutY.Add(QueryTarget.Bounds.Origin.Y);
+		CalloutZ.Add(QueryTarget.Bounds.Origin.Z);
+		CalloutRadius.Add(QueryTarget.Bounds.SphereRadius);
+	});
+
+	const int32 NumCallouts = CalloutInteractables.Num();
+	// The padding lanes are tested but never read
+	while (CalloutX.Num() % 4 != 0)
+	{
+		CalloutX.Add(0.0);
+		CalloutY.Add(0.0);
+		CalloutZ.Add(0.0);
+		CalloutRadius.Add(0.0);
+	}
+
+	auto Splat = [](double Value) { return MakeVectorRegisterDouble(Value, Value, Value, Value); };
+
+	const double CullDistance = CVarOGInteractionsCalloutCullDistance.GetValueOnGameThread();
+	const VectorRegister4Double MaxDistance = Splat(CullDistance > 0.0 ? CullDistance : double(TNumericLimits<float>::Max()));
+	const VectorRegister4Double ViewX = Splat(View.Location.X);
+	const VectorRegister4Double ViewY = Splat(View.Location.Y);
+	const VectorRegister4Double ViewZ = Splat(View.Location.Z);
+
+	// Frustum planes face outwards, X Y Z W per plane
+	TArray<VectorRegister4Double, TInlineAllocator<32>> Planes;
+	for (const FPlane& Plane : Frustum.Planes)
+	{
+		Planes.Add(Splat(Plane.X));
+		Planes.Add(Splat(Plane.Y));
+		Planes.Add(Splat(Plane.Z));
+		Planes.Add(Splat(Plane.W));
+	}
+
+	for (int32 First = 0; First < NumCallouts; First += 4)
+	{
+		const VectorRegister4Double X = VectorLoad(&CalloutX[First]);
+		const VectorRegister4Double Y = VectorLoad(&CalloutY[First]);
+		const VectorRegister4Double Z = VectorLoad(&CalloutZ[First]);
+		const VectorRegister4Double Radius = VectorLoad(&CalloutRadius[First]);
+
+		const VectorRegister4Double DeltaX = VectorSubtract(X, ViewX);
+		const VectorRegister4Double DeltaY = VectorSubtract(Y, ViewY);
+		const VectorRegister4Double DeltaZ = VectorSubtract(Z, ViewZ);
+		const VectorRegister4Double DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+		const VectorRegister4Double Reach = VectorAdd(MaxDistance, Radius);
+		VectorRegister4Double Outside = VectorCompareGT(DistanceSquared, VectorMultiply(Reach, Reach));
+
+		for (int32 Plane = 0; Plane < Planes.Num(); Plane += 4)
+		{
+			const VectorRegister4Double PlaneDistance = VectorSubtract(
+				VectorMultiplyAdd(X, Planes[Plane], VectorMultiplyAdd(Y, Planes[Plane + 1], VectorMultiply(Z, Planes[Plane + 2]))),
+				Planes[Plane + 3]);
+			Outside = VectorBitwiseOr(Outside, VectorCompareGT(PlaneDistance, Radius));
+		}
+
+		const uint32 OutsideMask = VectorMaskBits(Outside);
+		const int32 Last = FMath::Min(First + 4, NumCallouts);
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			UOGInteractableComponent_Base& Interactable = *CalloutInteractables[Index];
+			if (OutsideMask & (1u << (Index - First)))
+			{
+				if (Interactable.bInCalloutView)
+				{
+					Interactable.bInCalloutView = false;
+					PendingCalloutDemotions.Add(&Interactable);
+				}
+				continue;
+			}
+
+			Interactable.bInCalloutView = true;
+			++LastFrameVisibleCallouts;
+			if (Interactable.CalloutEpoch != CalloutEpoch)
+			{
+				Interactable.CalloutEpoch = CalloutEpoch;
+				Interactable.bDefaultUIStateDirty = false;
+				Interactable.TriggerUIStateDefaultRefresh();
+				++LastFrameCalloutRefreshes;
+			}
+		}
+	}
+
+	const auto* PlayerController = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
+	DrainCalloutDemotions(PlayerController ? PlayerController->GetPawn() : nullptr);
+}
+
+void UOGInteractionConveyanceSubsystem::DrainCalloutDemotions(const AActor* LocalPawn)
+{
+	const auto* LocalInteractor = UOGInteractions_FunctionLibrary::GetInteractorComponent(LocalPawn);
+	const int32 NumToDemote = FMath::Clamp(CVarOGInteractionsCalloutDemotionsPerFrame.GetValueOnGameThread(), 0, PendingCalloutDemotions.Num());
+	for (int32 Index = 0; Index < NumToDemote; ++Index)
+	{
+		UOGInteractableComponent_Base* Interactable = PendingCalloutDemotions[Index].Get();
+		// Came back into view before its turn, its state is still current
+		if (!Interactable || Interactable->bInCalloutView)
+			continue;
+
+		// Evaluated again when it next comes into view
+		Interactable->CalloutEpoch = 0;
+
+		const bool bTargeted = LocalInteractor
+			&& (LocalInteractor->GetInteractionCandidate() == Interactable || LocalInteractor->GetInteractionFocus() == Interactable);
+		if (Interactable->CulledUIState.IsValid() && !bTargeted)
+		{
+			Interactable->SetUIState(Interactable->CulledUIState);
+		}
+	}
+	PendingCalloutDemotions.RemoveAt(0, NumToDemote);
+}
+
+void UOGInteractionConveyanceSubsystem::MarkInteractablesDirty(const FGameplayTagContainer& FilterTags, TSubclassOf<UOGInteractableComponent_Base> FilterClass)
+{
+	const auto* Registry = UOGInteractableRegistrySubsystem::Get(this);
+	if (!Registry)
+		return;
+
+	Registry->ForEachInteractable([&](UOGInteractableComponent_Base& Interactable, const UPrimitiveComponent& QueryTarget)
+	{
+		if (FilterClass && !Interactable.IsA(FilterClass))
+			return;
+		if (!FilterTags.IsEmpty() && !Interactable.InteractableTags.HasAny(FilterTags))
+			return;
+
+		MarkInteractableDirty(&Interactable);
+	});
+}
+
+void UOGInteractionConveyanceSubsystem::MarkInteractableDirty(UOGInteractableComponent_Base* Interactable)
+{
+	if (!Interactable)
+		return;
+
+	// Whatever made it dirty may also change what its getters return
+	Interactable->InvalidateUIStateCache();
+	if (Interactable->bDefaultUIStateDirty || !Interactable->CanRefreshDefaultUIState())
+		return;
+
+	Interactable->bDefaultUIStateDirty = true;
+	DirtyInteractables.Add(Interactable);
+	bDirtyInteractablesNeedSort = true;
+}
+
+void UOGInteractionConveyanceSubsystem::SortDirtyInteractables()
+{
+	// Drop what's already been refreshed, so the sort only covers what is left
+	DirtyInteractables.RemoveAt(0, NextDirtyInteractable);
+	NextDirtyInteractable = 0;
+	bDirtyInteractablesNeedSort = false;
+
+	FMinimalViewInfo View;
+	FConvexVolume Frustum;
+	if (!GetLocalView(View, Frustum))
+		return;
+
+	struct FSortEntry
+	{
+		TWeakObjectPtr<UOGInteractableComponent_Base> Interactable;
+		bool bInView = false;
+		double DistanceSquared = 0.0;
+	};
+	TArray<FSortEntry> Entries;
+	Entries.Reserve(DirtyInteractables.Num());
+	for (const TWeakObjectPtr<UOGInteractableComponent_Base>& WeakInteractable : DirtyInteractables)
+	{
+		const auto* Interactable = WeakInteractable.Get();
+		if (!Interactable)
+			continue;
+
+		FSortEntry& Entry = Entries.Add_GetRef({ WeakInteractable, false, TNumericLimits<double>::Max() });
+		if (const auto* QueryTarget = Interactable->GetQueryTarget())
+		{
+			const FBoxSphereBounds& Bounds = QueryTarget->Bounds;
+			Entry.bInView = Frustum.IntersectSphere(Bounds.Origin, Bounds.SphereRadius);
+			Entry.DistanceSquared = FVector::DistSquared(Bounds.Origin, View.Location);
+		}
+	}
+	// Anything in view ahead of everything that isn't, closest first
+	Entries.Sort([](const FSortEntry& A, const FSortEntry& B)
+	{
+		return A.bInView != B.bInView ? A.bInView : A.DistanceSquared < B.DistanceSquared;
+	});
+
+	DirtyInteractables.Reset();
+	for (const FSortEntry& Entry : Entries)
+	{
+		DirtyInteractables.Add(Entry.Interactable);
+	}
+}
+
+void UOGInteractionConveyanceSubsystem::DrainDirtyInteractables()
+{
+	LastFrameDirtyRefreshes = 0;
+	if (NextDirtyInteractable >= DirtyInteractables.Num())
+	{
+		DirtyInteractables.Reset();
+		NextDirtyInteractable = 0;
+		return;
+	}
+
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_DirtyRefresh);
+
+	if (bDirtyInteractablesNeedSort)
+	{
+		SortDirtyInteractables();
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + CVarOGInteractionsDirtyRefreshBudgetMs.GetValueOnGameThread() / 1000.0;
+	while (NextDirtyInteractable < DirtyInteractables.Num())
+	{
+		UOGInteractableComponent_Base* Interactable = DirtyInteractables[NextDirtyInteractable++].Get();
+		// Gone, or already refreshed by the callout pass
+		if (!Interactable || !Interactable->bDefaultUIStateDirty)
+			continue;
+
+		// Cleared first, so the refresh itself may mark it again
+		Interactable->bDefaultUIStateDirty = false;
+		Interactable->TriggerUIStateDefaultRefresh();
+		++LastFrameDirtyRefreshes;
+
+		if (FPlatformTime::Seconds() >= EndTime)
+			break;
+	}
+}
+
+void UOGInteractionConveyanceSubsystem::InvalidateUIStateDependency(FGameplayTag Token)
+{
+	if (Token.IsValid())
+	{
+		++UIStateDependencyVersions.FindOrAdd(Token);
+	}
+}
+
+uint32 UOGInteractionConveyanceSubsystem::GetUIStateDependencyVersion(const FGameplayTagContainer& Dependencies) const
+{
+	if (UIStateDependencyVersions.Num() == 0)
+		return 0;
+
+	uint32 Version = 0;
+	for (const FGameplayTag& Dependency : Dependencies)
+	{
+		for (FGameplayTag Tag = Dependency; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+		{
+			Version += UIStateDependencyVersions.FindRef(Tag);
+		}
+	}
+	return Version;
+}
+
+bool UOGInteractionConveyanceSubsystem::GetLocalView(FMinimalViewInfo& OutView, FConvexVolume& OutFrustum) const
+{
+	const auto* PlayerController = UOGInteractions_FunctionLibrary::GetLocalPlayerController(this);
+	const auto* CameraManager = PlayerController ? PlayerController->PlayerCameraManager.Get() : nullptr;
+	if (!CameraManager)
+		return false;
+
+	OutView = CameraManager->GetCameraCacheView();
+	FMatrix ViewMatrix, ProjectionMatrix, ViewProjectionMatrix;
+	UGameplayStatics::GetViewProjectionMatrix(OutView, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+	GetViewFrustumBounds(OutFrustum, ViewProjectionMatrix, true);
+	return true;
+}
+
+bool UOGInteractionConveyanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,149 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/OGInteractionQuerySubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Utilities/OGInteractions_Stats.h"
+#include "Utilities/OGInteractions_Types.h"
+
+static TAutoConsoleVariable<float> CVarOGInteractionsBatchedQueryBudgetMs(
+	TEXT("OG.Interactions.BatchedQueryBudgetMs"),
+	1.f,
+	TEXT("Game thread time (ms) per frame for batched interactor queries. Interactors that don't fit are queried on a later frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarOGInteractionsBatchedQueryChunkSize(
+	TEXT("OG.Interactions.BatchedQueryChunkSize"),
+	32,
+	TEXT("Batched interactor queries traced per ParallelFor, the budget is checked between chunks."),
+	ECVF_Default
+);
+
+UOGInteractionQuerySubsystem* UOGInteractionQuerySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UOGInteractionQuerySubsystem>() : nullptr;
+}
+
+void UOGInteractionQuerySubsystem::Deinitialize()
+{
+	Interactors.Empty();
+	Batch.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UOGInteractionQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOGInteractionQuerySubsystem, STATGROUP_Tickables);
+}
+
+void UOGInteractionQuerySubsystem::RegisterInteractor(UOGInteractorComponent* Interactor)
+{
+	if (Interactor)
+	{
+		Interactors.AddUnique(Interactor);
+	}
+}
+
+void UOGInteractionQuerySubsystem::UnregisterInteractor(UOGInteractorComponent* Interactor)
+{
+	Interactors.Remove(Interactor);
+}
+
+void UOGInteractionQuerySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	OG_INTERACTIONS_SCOPE(STAT_OGInteractions_BatchedQueries);
+
+	Interactors.RemoveAllSwap([](const TWeakObjectPtr<UOGInteractorComponent>& Interactor) { return !Interactor.IsValid(); });
+	LastFrameQueryCount = 0;
+	if (Interactors.Num() == 0)
+		return;
+
+	UWorld* World = GetWorld();
+	UOGInteractableRegistrySubsystem* Registry = UOGInteractableRegistrySubsystem::Get(World);
+	const FOGInteractableBVH* BVH = Registry ? Registry->GetInteractableBVH() : nullptr;
+	const double BudgetSeconds = CVarOGInteractionsBatchedQueryBudgetMs.GetValueOnGameThread() / 1000.0;
+	const int32 ChunkSize = FMath::Max(CVarOGInteractionsBatchedQueryChunkSize.GetValueOnGameThread(), 1);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Interactors can unregister while results are applied, so the count is re-read rather than cached
+	int32 NumVisited = 0;
+	while (NumVisited < Interactors.Num() && FPlatformTime::Seconds() - StartTime < BudgetSeconds)
+	{
+		// Gather on the game thread, actors aren't safe to read from the workers
+		Batch.Reset();
+		while (Batch.Num() < ChunkSize && NumVisited < Interactors.Num())
+		{
+			NextInteractor %= Interactors.Num();
+			UOGInteractorComponent* Interactor = Interactors[NextInteractor++].Get();
+			++NumVisited;
+
+			FBatchedQuery Query;
+			if (BuildQuery(Interactor, Query))
+			{
+				Query.bUseBVH = Query.bUseBVH && BVH;
+				Batch.Add(MoveTemp(Query));
+			}
+			else if (Interactor && Interactor->GetInteractionCandidate())
+			{
+				// Nothing resolves a skipped interactor's hover any more, so it would otherwise stick
+				Interactor->ClearInteractionCandidate();
+			}
+		}
+
+		ParallelFor(Batch.Num(), [this, World, BVH](int32 QueryIndex)
+		{
+			FBatchedQuery& Query = Batch[QueryIndex];
+			Query.bHit = Query.bUseBVH
+				? BVH->Raycast(Query.Start, Query.End, Query.BVHHit)
+				: World->LineTraceSingleByChannel(Query.HitResult, Query.Start, Query.End, OG_ECC_INTERACTABLE, *Query.QueryParams);
+		});
+
+		for (FBatchedQuery& Query : Batch)
+		{
+			UOGInteractorComponent* Interactor = Query.Interactor.Get();
+			if (!Interactor)
+				continue;
+
+			if (Query.bHit && Query.bUseBVH)
+			{
+				Query.bHit = UOGInteractableRegistrySubsystem::MakeHitResult(Query.BVHHit, Query.Start, Query.End, Query.HitResult);
+			}
+			if (Registry)
+			{
+				Registry->RecordTrace();
+			}
+			Interactor->HandleTraceResult(Query.bHit ? &Query.HitResult : nullptr);
+		}
+		LastFrameQueryCount += Batch.Num();
+	}
+}
+
+bool UOGInteractionQuerySubsystem::BuildQuery(UOGInteractorComponent* Interactor, FBatchedQuery& OutQuery) const
+{
+	const AActor* Owner = Interactor ? Interactor->GetOwner() : nullptr;
+	// Simulated proxies, or a pawn its client no longer controls
+	if (!Owner || !Interactor->IsRegistered() || !Interactor->ShouldRunBatchedQueries())
+		return false;
+
+	FVector EyeLocation;
+	FRotator EyeRotation;
+	Owner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+	OutQuery.Interactor = Interactor;
+	OutQuery.Start = EyeLocation;
+	OutQuery.End = EyeLocation + EyeRotation.Vector() * Interactor->RaycastRange;
+	OutQuery.QueryParams = &Interactor->TraceQueryParams;
+	OutQuery.bUseBVH = Interactor->TraceMode == EOGInteractorTraceMode::InteractableBVH;
+	return true;
+}
+
+bool UOGInteractionQuerySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
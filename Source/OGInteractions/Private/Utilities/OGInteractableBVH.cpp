@@ -0,0 +1,491 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Utilities/OGInteractableBVH.h"
+
+#include "Algo/Sort.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+
+namespace OGInteractableBVH
+{
+	// Padding on leaf bounds, small motions (doors settling, bobbing pickups) stay inside and skip the refit
+	constexpr double FatMargin = 10.0;
+	constexpr int32 MaxLeavesPerNode = 4;
+
+	// Segment vs AABB slab test on all three axes at once. InvDirection components are huge for axis aligned rays
+	FORCEINLINE bool IntersectSlabs(const VectorRegister4Double& Min, const VectorRegister4Double& Max, const VectorRegister4Double& Origin, const VectorRegister4Double& InvDirection, double MaxDistance, double& OutNear)
+	{
+		const VectorRegister4Double T1 = VectorMultiply(VectorSubtract(Min, Origin), InvDirection);
+		const VectorRegister4Double T2 = VectorMultiply(VectorSubtract(Max, Origin), InvDirection);
+		// VectorStoreAligned needs the register's alignment, which is 32 with AVX
+		alignas(alignof(VectorRegister4Double)) double Near[4];
+		alignas(alignof(VectorRegister4Double)) double Far[4];
+		VectorStoreAligned(VectorMin(T1, T2), Near);
+		VectorStoreAligned(VectorMax(T1, T2), Far);
+
+		const double TNear = FMath::Max3(Near[0], Near[1], Near[2]);
+		const double TFar = FMath::Min3(Far[0], Far[1], Far[2]);
+		OutNear = FMath::Max(TNear, 0.0);
+		return TNear <= TFar && TFar >= 0.0 && TNear <= MaxDistance;
+	}
+
+	FORCEINLINE VectorRegister4Double MakeRegister(const FVector& V)
+	{
+		return MakeVectorRegisterDouble(V.X, V.Y, V.Z, 0.0);
+	}
+
+	FORCEINLINE VectorRegister4Double MakeInvDirection(const VectorRegister4Double& Direction)
+	{
+		const VectorRegister4Double Zero = VectorZeroDouble();
+		const VectorRegister4Double BigNumber = MakeVectorRegisterDouble(UE_BIG_NUMBER, UE_BIG_NUMBER, UE_BIG_NUMBER, UE_BIG_NUMBER);
+		return VectorSelect(VectorCompareEQ(Direction, Zero), BigNumber, VectorDivide(VectorOneDouble(), Direction));
+	}
+
+	// Registers hold positions and directions with W = 0, Direction is normalized
+	FORCEINLINE bool RaySphere(const VectorRegister4Double& Origin, const VectorRegister4Double& Direction, const VectorRegister4Double& Center, double Radius, double& OutDistance)
+	{
+		const VectorRegister4Double ToOrigin = VectorSubtract(Origin, Center);
+		const double B = VectorDot3Scalar(ToOrigin, Direction);
+		const double C = VectorDot3Scalar(ToOrigin, ToOrigin) - FMath::Square(Radius);
+		if (C <= 0.0)
+		{
+			OutDistance = 0.0;
+			return true;
+		}
+		const double H = FMath::Square(B) - C;
+		if (H < 0.0 || B > 0.0)
+			return false;
+
+		OutDistance = -B - FMath::Sqrt(H);
+		return true;
+	}
+
+	// Capsule as the segment A-B swept by Radius
+	bool RayCapsule(const VectorRegister4Double& Origin, const VectorRegister4Double& Direction, const VectorRegister4Double& A, const VectorRegister4Double& B, double Radius, double& OutDistance)
+	{
+		const VectorRegister4Double BA = VectorSubtract(B, A);
+		const VectorRegister4Double OA = VectorSubtract(Origin, A);
+		const double BABA = VectorDot3Scalar(BA, BA);
+		const double BARD = VectorDot3Scalar(BA, Direction);
+		const double BAOA = VectorDot3Scalar(BA, OA);
+		const double OAOA = VectorDot3Scalar(OA, OA);
+
+		// Starting inside: |OA - t * BA|^2 at the closest point on the segment, from the dots above
+		const double SegmentT = BABA > 0.0 ? FMath::Clamp(BAOA / BABA, 0.0, 1.0) : 0.0;
+		if (OAOA - 2.0 * SegmentT * BAOA + FMath::Square(SegmentT) * BABA <= FMath::Square(Radius))
+		{
+			OutDistance = 0.0;
+			return true;
+		}
+
+		// Cylinder body, skipped for rays parallel to the axis
+		const double QA = BABA - FMath::Square(BARD);
+		if (QA > UE_KINDA_SMALL_NUMBER)
+		{
+			const double RDOA = VectorDot3Scalar(Direction, OA);
+			const double QB = BABA * RDOA - BAOA * BARD;
+			const double QC = BABA * OAOA - FMath::Square(BAOA) - FMath::Square(Radius) * BABA;
+			const double H = FMath::Square(QB) - QA * QC;
+			if (H < 0.0)
+				return false;
+
+			const double T = (-QB - FMath::Sqrt(H)) / QA;
+			const double Y = BAOA + T * BARD;
+			if (Y > 0.0 && Y < BABA)
+			{
+				OutDistance = T;
+				return T >= 0.0;
+			}
+			// Outside the body, so the hit (if any) is on the cap at that end
+			return RaySphere(Origin, Direction, Y <= 0.0 ? A : B, Radius, OutDistance);
+		}
+		return RaySphere(Origin, Direction, BARD > 0.0 ? A : B, Radius, OutDistance);
+	}
+}
+
+bool FOGInteractableBVH::ReadShape(const UShapeComponent* Shape, FLeaf& OutLeaf)
+{
+	if (!Shape)
+		return false;
+
+	const FTransform& Transform = Shape->GetComponentTransform();
+	OutLeaf.Center = Transform.GetLocation();
+	OutLeaf.Rotation = Transform.GetRotation();
+
+	if (const auto* Box = Cast<UBoxComponent>(Shape))
+	{
+		OutLeaf.Shape = EShape::Box;
+		OutLeaf.Extent = Box->GetScaledBoxExtent();
+		return true;
+	}
+	if (const auto* Sphere = Cast<USphereComponent>(Shape))
+	{
+		OutLeaf.Shape = EShape::Sphere;
+		OutLeaf.Extent = FVector(Sphere->GetScaledSphereRadius(), 0.0, 0.0);
+		return true;
+	}
+	if (const auto* Capsule = Cast<UCapsuleComponent>(Shape))
+	{
+		OutLeaf.Shape = EShape::Capsule;
+		OutLeaf.Extent = FVector(Capsule->GetScaledCapsuleRadius(), 0.0, Capsule->GetScaledCapsuleHalfHeight());
+		return true;
+	}
+	return false;
+}
+
+FBox FOGInteractableBVH::CalcBounds(const FLeaf& Leaf)
+{
+	switch (Leaf.Shape)
+	{
+	case EShape::Sphere:
+		return FBox::BuildAABB(Leaf.Center, FVector(Leaf.Extent.X));
+	case EShape::Capsule:
+	{
+		const FVector Axis = Leaf.Rotation.GetAxisZ() * FMath::Max(Leaf.Extent.Z - Leaf.Extent.X, 0.0);
+		return FBox::BuildAABB(Leaf.Center, Axis.GetAbs() + FVector(Leaf.Extent.X));
+	}
+	case EShape::Box:
+	default:
+		return FBox(-Leaf.Extent, Leaf.Extent).TransformBy(FTransform(Leaf.Rotation, Leaf.Center));
+	}
+}
+
+bool FOGInteractableBVH::RaycastLeaf(const FLeaf& Leaf, const VectorRegister4Double& Start, const VectorRegister4Double& Direction, double MaxDistance, double& OutDistance)
+{
+	const VectorRegister4Double Center = OGInteractableBVH::MakeRegister(Leaf.Center);
+	bool bHit = false;
+	switch (Leaf.Shape)
+	{
+	case EShape::Sphere:
+		bHit = OGInteractableBVH::RaySphere(Start, Direction, Center, Leaf.Extent.X, OutDistance);
+		break;
+	case EShape::Capsule:
+	{
+		const VectorRegister4Double Axis = OGInteractableBVH::MakeRegister(Leaf.Rotation.GetAxisZ() * FMath::Max(Leaf.Extent.Z - Leaf.Extent.X, 0.0));
+		bHit = OGInteractableBVH::RayCapsule(Start, Direction, VectorSubtract(Center, Axis), VectorAdd(Center, Axis), Leaf.Extent.X, OutDistance);
+		break;
+	}
+	case EShape::Box:
+	{
+		// Into the box's space, where it is an AABB
+		const VectorRegister4Double Rotation = VectorLoad(&Leaf.Rotation.X);
+		const VectorRegister4Double LocalStart = VectorQuaternionInverseRotateVector(Rotation, VectorSubtract(Start, Center));
+		const VectorRegister4Double LocalDirection = VectorQuaternionInverseRotateVector(Rotation, Direction);
+		const VectorRegister4Double Extent = OGInteractableBVH::MakeRegister(Leaf.Extent);
+		bHit = OGInteractableBVH::IntersectSlabs(
+			VectorNegate(Extent), Extent, LocalStart, OGInteractableBVH::MakeInvDirection(LocalDirection), MaxDistance, OutDistance
+		);
+		break;
+	}
+	}
+	return bHit && OutDistance <= MaxDistance;
+}
+
+bool FOGInteractableBVH::AddShape(const UShapeComponent* Shape, bool bDisabled)
+{
+	FLeaf NewLeaf;
+	if (!ReadShape(Shape, NewLeaf))
+		return false;
+
+	NewLeaf.QueryTarget = TObjectKey<UPrimitiveComponent>(Shape);
+	NewLeaf.bDisabled = bDisabled;
+	NewLeaf.FatBounds = CalcBounds(NewLeaf).ExpandBy(OGInteractableBVH::FatMargin);
+
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	if (const int32* Existing = LeafByTarget.Find(NewLeaf.QueryTarget))
+	{
+		Leaves[*Existing].bRemoved = true;
+		++NumRemoved;
+	}
+	const int32 LeafIndex = Leaves.Add(MoveTemp(NewLeaf));
+	LeafByTarget.Add(Leaves[LeafIndex].QueryTarget, LeafIndex);
+	PendingLeaves.Add(LeafIndex);
+	return true;
+}
+
+void FOGInteractableBVH::RemoveShape(const UPrimitiveComponent* Shape)
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	int32 LeafIndex;
+	if (LeafByTarget.RemoveAndCopyValue(TObjectKey<UPrimitiveComponent>(Shape), LeafIndex))
+	{
+		Leaves[LeafIndex].bRemoved = true;
+		++NumRemoved;
+	}
+}
+
+void FOGInteractableBVH::UpdateShape(const UShapeComponent* Shape)
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	const int32* LeafIndex = LeafByTarget.Find(TObjectKey<UPrimitiveComponent>(Shape));
+	if (!LeafIndex)
+		return;
+
+	FLeaf& Leaf = Leaves[*LeafIndex];
+	ReadShape(Shape, Leaf);
+
+	const FBox Bounds = CalcBounds(Leaf);
+	if (Leaf.FatBounds.IsInside(Bounds))
+		return;
+
+	Leaf.FatBounds = Bounds.ExpandBy(OGInteractableBVH::FatMargin);
+	if (Leaf.NodeIndex != INDEX_NONE)
+	{
+		RefitFrom(Leaf.NodeIndex, Leaf.FatBounds);
+		++NumRefits;
+	}
+}
+
+void FOGInteractableBVH::SetShapeDisabled(const UPrimitiveComponent* Shape, bool bDisabled)
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	if (const int32* LeafIndex = LeafByTarget.Find(TObjectKey<UPrimitiveComponent>(Shape)))
+	{
+		Leaves[*LeafIndex].bDisabled = bDisabled;
+	}
+}
+
+bool FOGInteractableBVH::NeedsRebuild() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	// Refits only ever grow bounds, so past a point the tree is cheaper to rebuild than to keep walking
+	return PendingLeaves.Num() > 0 || NumRemoved > 0 || NumRefits > FMath::Max(Leaves.Num() / 4, 16);
+}
+
+int32 FOGInteractableBVH::Num() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	return LeafByTarget.Num();
+}
+
+void FOGInteractableBVH::Rebuild()
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+
+	// Compact away removed leaves
+	TArray<FLeaf> LiveLeaves;
+	LiveLeaves.Reserve(LeafByTarget.Num());
+	LeafByTarget.Reset();
+	for (FLeaf& Leaf : Leaves)
+	{
+		if (!Leaf.bRemoved)
+		{
+			Leaf.FatBounds = CalcBounds(Leaf).ExpandBy(OGInteractableBVH::FatMargin);
+			LeafByTarget.Add(Leaf.QueryTarget, LiveLeaves.Num());
+			LiveLeaves.Add(MoveTemp(Leaf));
+		}
+	}
+	Leaves = MoveTemp(LiveLeaves);
+	PendingLeaves.Reset();
+	NumRemoved = 0;
+	NumRefits = 0;
+
+	Nodes.Reset(Leaves.Num() * 2 / OGInteractableBVH::MaxLeavesPerNode + 1);
+	LeafOrder.SetNumUninitialized(Leaves.Num());
+	TArray<FVector> Centroids;
+	Centroids.SetNumUninitialized(Leaves.Num());
+	for (int32 LeafIndex = 0; LeafIndex < Leaves.Num(); ++LeafIndex)
+	{
+		LeafOrder[LeafIndex] = LeafIndex;
+		Centroids[LeafIndex] = Leaves[LeafIndex].FatBounds.GetCenter();
+	}
+
+	if (Leaves.Num() > 0)
+	{
+		BuildRecursive(INDEX_NONE, 0, Leaves.Num(), Centroids);
+	}
+}
+
+int32 FOGInteractableBVH::BuildRecursive(int32 Parent, int32 First, int32 Count, TArray<FVector>& Centroids)
+{
+	FBox Bounds(ForceInit);
+	FBox CentroidBounds(ForceInit);
+	for (int32 OrderIndex = First; OrderIndex < First + Count; ++OrderIndex)
+	{
+		Bounds += Leaves[LeafOrder[OrderIndex]].FatBounds;
+		CentroidBounds += Centroids[LeafOrder[OrderIndex]];
+	}
+
+	const int32 NodeIndex = Nodes.AddDefaulted();
+	Nodes[NodeIndex].Min = OGInteractableBVH::MakeRegister(Bounds.Min);
+	Nodes[NodeIndex].Max = OGInteractableBVH::MakeRegister(Bounds.Max);
+	Nodes[NodeIndex].Parent = Parent;
+
+	if (Count <= OGInteractableBVH::MaxLeavesPerNode)
+	{
+		Nodes[NodeIndex].ChildOrFirst = First;
+		Nodes[NodeIndex].NumLeaves = Count;
+		for (int32 OrderIndex = First; OrderIndex < First + Count; ++OrderIndex)
+		{
+			Leaves[LeafOrder[OrderIndex]].NodeIndex = NodeIndex;
+		}
+		return NodeIndex;
+	}
+
+	// Median split on the widest axis of the centroids
+	const FVector Extent = CentroidBounds.GetExtent();
+	const int32 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+	const int32 Half = Count / 2;
+	TArrayView<int32> Range(LeafOrder.GetData() + First, Count);
+	Algo::Sort(Range, [&Centroids, Axis](int32 A, int32 B)
+	{
+		return Centroids[A][Axis] < Centroids[B][Axis];
+	});
+
+	BuildRecursive(NodeIndex, First, Half, Centroids);
+	const int32 RightIndex = BuildRecursive(NodeIndex, First + Half, Count - Half, Centroids);
+	Nodes[NodeIndex].ChildOrFirst = RightIndex;
+	return NodeIndex;
+}
+
+void FOGInteractableBVH::RefitFrom(int32 NodeIndex, const FBox& Bounds)
+{
+	const VectorRegister4Double Min = OGInteractableBVH::MakeRegister(Bounds.Min);
+	const VectorRegister4Double Max = OGInteractableBVH::MakeRegister(Bounds.Max);
+	for (int32 Index = NodeIndex; Index != INDEX_NONE; Index = Nodes[Index].Parent)
+	{
+		Nodes[Index].Min = VectorMin(Nodes[Index].Min, Min);
+		Nodes[Index].Max = VectorMax(Nodes[Index].Max, Max);
+	}
+}
+
+bool FOGInteractableBVH::Raycast(const FVector& Start, const FVector& End, FOGInteractableBVHHit& OutHit) const
+{
+	const FVector Delta = End - Start;
+	const double Length = Delta.Size();
+	if (Length <= UE_SMALL_NUMBER)
+		return false;
+
+	const FVector Direction = Delta / Length;
+	const VectorRegister4Double Origin = OGInteractableBVH::MakeRegister(Start);
+	const VectorRegister4Double DirectionRegister = OGInteractableBVH::MakeRegister(Direction);
+	const VectorRegister4Double InvDirection = OGInteractableBVH::MakeInvDirection(DirectionRegister);
+
+	double ClosestDistance = Length;
+	int32 ClosestLeaf = INDEX_NONE;
+	auto TestLeaf = [&](int32 LeafIndex)
+	{
+		const FLeaf& Leaf = Leaves[LeafIndex];
+		double Distance;
+		if (IsQueryable(Leaf) && RaycastLeaf(Leaf, Origin, DirectionRegister, ClosestDistance, Distance))
+		{
+			ClosestDistance = Distance;
+			ClosestLeaf = LeafIndex;
+		}
+	};
+
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	if (Nodes.Num() > 0)
+	{
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(0);
+		while (Stack.Num() > 0)
+		{
+			const int32 NodeIndex = Stack.Pop();
+			const FNode& Node = Nodes[NodeIndex];
+			double NodeDistance;
+			if (!OGInteractableBVH::IntersectSlabs(Node.Min, Node.Max, Origin, InvDirection, ClosestDistance, NodeDistance))
+				continue;
+
+			if (Node.NumLeaves > 0)
+			{
+				for (int32 OrderIndex = Node.ChildOrFirst; OrderIndex < Node.ChildOrFirst + Node.NumLeaves; ++OrderIndex)
+				{
+					TestLeaf(LeafOrder[OrderIndex]);
+				}
+			}
+			else
+			{
+				Stack.Add(Node.ChildOrFirst);
+				Stack.Add(NodeIndex + 1);
+			}
+		}
+	}
+	for (const int32 LeafIndex : PendingLeaves)
+	{
+		TestLeaf(LeafIndex);
+	}
+
+	if (ClosestLeaf == INDEX_NONE)
+		return false;
+
+	OutHit.QueryTarget = Leaves[ClosestLeaf].QueryTarget;
+	OutHit.Distance = ClosestDistance;
+	OutHit.Location = Start + Direction * ClosestDistance;
+	return true;
+}
+
+void FOGInteractableBVH::ConeQuery(const FVector& Origin, const FVector& Direction, double MaxDistance, float HalfAngleDegrees, TArray<FOGInteractableBVHHit>& OutHits) const
+{
+	OutHits.Reset();
+	const FVector UnitDirection = Direction.GetSafeNormal();
+	const double HalfAngle = FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.f, 180.f));
+
+	// Bounding sphere vs cone: within range, and within the half angle once the sphere's own angular size is allowed for
+	auto IsInCone = [&](const FVector& Center, double Radius, double& OutDistance)
+	{
+		const FVector ToCenter = Center - Origin;
+		OutDistance = ToCenter.Size();
+		if (OutDistance - Radius > MaxDistance)
+			return false;
+		if (OutDistance <= Radius)
+			return true;
+
+		const double Angle = FMath::Acos(FMath::Clamp((ToCenter / OutDistance) | UnitDirection, -1.0, 1.0));
+		return Angle - FMath::Asin(Radius / OutDistance) <= HalfAngle;
+	};
+	auto TestLeaf = [&](int32 LeafIndex)
+	{
+		const FLeaf& Leaf = Leaves[LeafIndex];
+		double Distance;
+		const FBox Bounds = CalcBounds(Leaf);
+		if (IsQueryable(Leaf) && IsInCone(Bounds.GetCenter(), Bounds.GetExtent().Size(), Distance))
+		{
+			OutHits.Add({Leaf.QueryTarget, Distance, Leaf.Center});
+		}
+	};
+
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	if (Nodes.Num() > 0)
+	{
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(0);
+		while (Stack.Num() > 0)
+		{
+			const int32 NodeIndex = Stack.Pop();
+			const FNode& Node = Nodes[NodeIndex];
+			alignas(alignof(VectorRegister4Double)) double Min[4];
+			alignas(alignof(VectorRegister4Double)) double Max[4];
+			VectorStoreAligned(Node.Min, Min);
+			VectorStoreAligned(Node.Max, Max);
+			const FBox Bounds(FVector(Min[0], Min[1], Min[2]), FVector(Max[0], Max[1], Max[2]));
+			double NodeDistance;
+			if (!IsInCone(Bounds.GetCenter(), Bounds.GetExtent().Size(), NodeDistance))
+				continue;
+
+			if (Node.NumLeaves > 0)
+			{
+				for (int32 OrderIndex = Node.ChildOrFirst; OrderIndex < Node.ChildOrFirst + Node.NumLeaves; ++OrderIndex)
+				{
+					TestLeaf(LeafOrder[OrderIndex]);
+				}
+			}
+			else
+			{
+				Stack.Add(Node.ChildOrFirst);
+				Stack.Add(NodeIndex + 1);
+			}
+		}
+	}
+	for (const int32 LeafIndex : PendingLeaves)
+	{
+		TestLeaf(LeafIndex);
+	}
+
+	OutHits.Sort([](const FOGInteractableBVHHit& A, const FOGInteractableBVHHit& B)
+	{
+		return A.Distance < B.Distance;
+	});
+}
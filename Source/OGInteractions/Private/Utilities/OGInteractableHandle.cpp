@@ -0,0 +1,37 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Utilities/OGInteractableHandle.h"
+
+FOGInteractableHandle::FOGInteractableHandle(uint32 InIndex, uint32 InGeneration, bool bInLocal)
+{
+	check(InIndex <= MaxIndex && InGeneration <= MaxGeneration);
+	Value = (bInLocal ? 1u << 31 : 0u) | (InGeneration << IndexBits) | InIndex;
+}
+
+bool FOGInteractableHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 Index = GetIndex();
+	uint32 Generation = GetGeneration();
+	uint8 bLocal = IsLocal() ? 1 : 0;
+
+	Ar.SerializeIntPacked(Index);
+	Ar.SerializeIntPacked(Generation);
+	Ar.SerializeBits(&bLocal, 1);
+
+	if (Ar.IsLoading())
+	{
+		bOutSuccess = Index <= MaxIndex && Generation <= MaxGeneration;
+		Value = bOutSuccess ? FOGInteractableHandle(Index, Generation, bLocal != 0).Value : 0;
+		return bOutSuccess;
+	}
+	bOutSuccess = true;
+	return true;
+}
+
+FString FOGInteractableHandle::ToString() const
+{
+	return IsValid()
+		? FString::Printf(TEXT("%s%u:%u"), IsLocal() ? TEXT("L") : TEXT(""), GetIndex(), GetGeneration())
+		: TEXT("Invalid");
+}
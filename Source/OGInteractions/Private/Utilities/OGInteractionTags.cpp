@@ -5,6 +5,7 @@ namespace OccamsGamkit
 	namespace Interactions
 	{
 		UE_DEFINE_GAMEPLAY_TAG(Raycast,						"OccamsGamekit.Interactions.Raycast")
+		UE_DEFINE_GAMEPLAY_TAG(PawnOverlap,					"OccamsGamekit.Interactions.PawnOverlap")
 
 		namespace InteractableComponent
 		{
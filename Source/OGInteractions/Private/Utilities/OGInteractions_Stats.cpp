@@ -0,0 +1,24 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Utilities/OGInteractions_Stats.h"
+
+DEFINE_STAT(STAT_OGInteractions_InteractorTrace);
+DEFINE_STAT(STAT_OGInteractions_BatchedQueries);
+DEFINE_STAT(STAT_OGInteractions_ResolveHit);
+DEFINE_STAT(STAT_OGInteractions_GetUIState);
+DEFINE_STAT(STAT_OGInteractions_OnUIStateChange);
+DEFINE_STAT(STAT_OGInteractions_OnRepDisabledChanged);
+DEFINE_STAT(STAT_OGInteractions_TryInteract);
+DEFINE_STAT(STAT_OGInteractions_CalloutVisibility);
+DEFINE_STAT(STAT_OGInteractions_DirtyRefresh);
+
+DEFINE_STAT(STAT_OGInteractions_Traces);
+DEFINE_STAT(STAT_OGInteractions_StateTransitions);
+DEFINE_STAT(STAT_OGInteractions_UIStateCacheHits);
+DEFINE_STAT(STAT_OGInteractions_UIStateCacheMisses);
+DEFINE_STAT(STAT_OGInteractions_CanInteractCacheHits);
+DEFINE_STAT(STAT_OGInteractions_CanInteractCacheMisses);
+DEFINE_STAT(STAT_OGInteractions_DroppedRequests);
+DEFINE_STAT(STAT_OGInteractions_RegisteredInteractables);
+
+CSV_DEFINE_CATEGORY_MODULE(OGINTERACTIONS_API, OGInteractions, true);
@@ -5,11 +5,19 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "OGFuture.h"
-#include "Components/ActorComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneComponent.h"
+#include "UObject/ObjectKey.h"
+#include "Utilities/OGInteractableHandle.h"
 #include "Utilities/OGInteractionTags.h"
 #include "OGFuture.h"
 #include "OGInteractableComponent_Base.generated.h"
 
+class UShapeComponent;
+class UMeshComponent;
+class UOGInteractableConveyanceProfile;
+class AOGInteractableStateManager;
+
 // TODO: Perhaps it would be best to leave *_Base as-is, then create a derived class: InteractableComponent_InputBinding
 // _No_, how else would you use it? Handling should be tied to the rest of the binding
 // Perhaps call it action-handling? Or, rather than stick in on here directly, we put it on a child class for example
@@ -22,6 +30,35 @@ DECLARE_DYNAMIC_DELEGATE_RetVal_OneParam(FGameplayTag, FGetUIStateDelegate, cons
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnUIStateChangedDelegate, const FGameplayTag&, NewUIState);
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnChangeStateNotificationDelegate, bool, bNewState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInteractableNetStateChanged, uint8, NetState);
+
+// Native counterparts of the UI state delegates, for C++ bindings (lambdas, UObject/raw methods) that don't need the Blueprint VM.
+// When bound, they are used in preference to the dynamic delegates.
+DECLARE_DELEGATE_RetVal_OneParam(FGameplayTag, FGetUIStateNativeDelegate, const AActor* /*Interactor*/);
+DECLARE_DELEGATE_OneParam(FOnUIStateChangedNativeDelegate, const FGameplayTag& /*NewUIState*/);
+
+/*
+ * The handlers bound on one Interactable, see the Set Delegate functions.
+ * Only allocated once something is bound, so Interactables conveyed through a profile don't carry them
+ */
+struct FOGInteractableHandlers
+{
+	FGetUIStateDelegate OnHover;
+	FGetUIStateDelegate OnFocus;
+	FGetUIStateDelegate GetDefaultState;
+	FOnUIStateChangedDelegate OnUIStateChanged;
+	FOnChangeStateNotificationDelegate OnDisabledChanged;
+
+	FGetUIStateNativeDelegate OnHoverNative;
+	FGetUIStateNativeDelegate OnFocusNative;
+	FGetUIStateNativeDelegate GetDefaultStateNative;
+	FOnUIStateChangedNativeDelegate OnUIStateChangedNative;
+
+	bool HasOnHover() const { return OnHoverNative.IsBound() || OnHover.IsBound(); }
+	bool HasOnFocus() const { return OnFocusNative.IsBound() || OnFocus.IsBound(); }
+	bool HasGetDefaultState() const { return GetDefaultStateNative.IsBound() || GetDefaultState.IsBound(); }
+	bool HasOnUIStateChanged() const { return OnUIStateChangedNative.IsBound() || OnUIStateChanged.IsBound(); }
+};
 
 /*
  * Container for visual delegates
@@ -55,10 +92,15 @@ struct FOGInteractableComponent_VisualDelegates
  *	The InteractorComponent runs locally only, and interacts with the Trigger functions.
  *	These call the OnUIStateChange functions, which only run locally:
  *		- GetOnHoverState, GetOnFocusState, GetGetDefaultState
- *	
+ *
+ *	This component never renders or collides itself, it only points at the QueryVolume/PhysicalRepresentation,
+ *	so it is a plain SceneComponent: no body instance, scene proxy or render state per Interactable.
+ *	There is no separate lightweight class next to a PrimitiveComponent one: the interactor, registry, BVH and state manager
+ *	all take this class, and UCLASSes can't share it across two parents without an interface call on every query.
+ *	OGInteractions.Benchmark.ComponentBase measures what the change saves per instance.
  */
 UCLASS(Blueprintable, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class OGINTERACTIONS_API UOGInteractableComponent_Base : public UPrimitiveComponent
+class OGINTERACTIONS_API UOGInteractableComponent_Base : public USceneComponent
 {
 	GENERATED_BODY()
 
@@ -67,10 +109,13 @@ protected:
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	/**
 	 * @brief Set the parameters for querying and updating your Interactable. These will be available when updating conveyance.
-	 * @param Id A Unique tag to identify this OGInteractableComponent from others on the same actor. Will be added to the queried volume to back-reference this component
+	 * @param Id A Unique tag to identify this OGInteractableComponent from others on the same actor, used in diagnostics. Lookups go through GetHandle
 	 * @param InQueryVolume The volume you use to query this interactable. If provided, will always be used to query.
 	 * @param InPhysicalRepresentation A mesh, skeletal mesh, etc. that represents this interactable. If the only option provided, it will be used to query. Otherwise it will be available when updating conveyance.
 	 * @param VisualDelegates Container for optional visual to pass into the InteractionComponent.
@@ -100,11 +145,51 @@ public:
 	UFUNCTION(BlueprintPure)
 	bool GetIsDisabled() const { return bDisabled; };
 
+	// Compact per-world reference to this Interactable, resolved through UOGInteractableRegistrySubsystem::ResolveHandle
+	UFUNCTION(BlueprintPure)
+	FOGInteractableHandle GetHandle() const { return Handle; }
+
+	// A compact game-defined state that replicates with bDisabled (e.g., opened, looted)
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void SetNetState(uint8 InNetState);
+	UFUNCTION(BlueprintPure)
+	uint8 GetNetState() const { return NetState; }
+	UPROPERTY(BlueprintAssignable)
+	FOnInteractableNetStateChanged OnNetStateChanged;
+
+	// (Server) An Interactor asked to interact through UOGInteractorComponent::RequestInteraction, after rate limiting.
+	// Returns whether the interaction went through, which confirms or rejects a client's prediction of it.
+	// Does nothing here, subclasses that bind input actions act on it
+	virtual bool HandleInteractionRequest(AActor* Interactor, const FGameplayTag& InputAction) { return false; }
+
+	// (Client) From UOGInteractorComponent::PredictInteraction: applies the predicted interaction and conveys it, false if it can't be predicted
+	bool BeginPredictedInteraction(AActor* Interactor, const FGameplayTag& InputAction);
+	// (Client) The server answered, or gave no answer in time. A rejection rolls back PredictDisabled and re-evaluates the UI state
+	void EndPredictedInteraction(AActor* Interactor, const FGameplayTag& InputAction, bool bConfirmed);
+
+	// (Client) For predicted behaviors: changes bDisabled locally until the server confirms, and restores it if the server rejects
+	UFUNCTION(BlueprintCallable)
+	void PredictDisabled(bool bInDisabled);
+
+	// Replicate bDisabled, NetState and the handle through the level's AOGInteractableStateManager, and not this component at all.
+	// The component must be stably named (placed in the level, or created in its actor's constructor), and SetDisabled called on the server
+	UPROPERTY(EditDefaultsOnly)
+	bool bReplicateStateThroughManager = false;
+
+	// (Server) Keeps the owning actor net dormant, state changes flush it and it goes straight back to sleep.
+	// Only for owners with nothing else that replicates continuously
+	UPROPERTY(EditDefaultsOnly)
+	bool bManageOwnerDormancy = false;
+
 	// TODO: This should be a global setting, not a per-interactable?
 	// Override in game file with expected behavior
 	UPROPERTY(EditDefaultsOnly)
 	FGameplayTag InteractionTriggerType = OccamsGamkit::Interactions::Raycast;
 
+	// Game-defined categories (e.g., Loot, a quest id), used to filter UOGInteractionConveyanceSubsystem::MarkInteractablesDirty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagContainer InteractableTags;
+
 	UFUNCTION(BlueprintCallable)
 	FOGFuture GetWhenInitialized() { return WhenInitialized;}
 
@@ -129,7 +214,19 @@ public:
 	void TriggerFocusEnd(const AActor* InInstigator);
 
 	UFUNCTION(BlueprintCallable)
-	void TriggerUIStateDefaultRefresh();
+	virtual void TriggerUIStateDefaultRefresh();
+
+	// Item-aware entry points used by the InteractorComponent. Item is the FHitResult::Item of the resolving hit
+	// (e.g., an instance index), single-target Interactables ignore it and route to the Triggers above
+	virtual void TriggerHoverForItem(const AActor* InInstigator, int32 Item) { TriggerHover(InInstigator); }
+	virtual void TriggerHoverEndForItem(const AActor* InInstigator, int32 Item) { TriggerHoverEnd(InInstigator); }
+	virtual void TriggerFocusForItem(const AActor* InInstigator, int32 Item) { TriggerFocus(InInstigator); }
+	virtual void TriggerFocusEndForItem(const AActor* InInstigator, int32 Item) { TriggerFocusEnd(InInstigator); }
+
+	// The Item a hit on the query target refers to, INDEX_NONE for single-target Interactables
+	virtual int32 GetInteractionItem(const FHitResult& HitResult) const { return INDEX_NONE; }
+	// Whether Item can't currently become a candidate. Disabling the whole Interactable already removes it from queries
+	virtual bool IsItemDisabled(int32 Item) const { return GetIsDisabled(); }
 
 	//// End Triggers
 	////////////////////////////////////////
@@ -142,45 +239,64 @@ public:
 	//// Begin Interaction Candidate handles, using a UI-based naming convention
 
 	// Logic for determining what UI state should be set on Hover
-	UPROPERTY()
-	FGetUIStateDelegate OnHoverDelegate;
 	UFUNCTION(BlueprintPure)
 	virtual FGameplayTag GetHoverStateFor(const AActor* Interactor) const;
 	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: GetUIState_OnHover"))
 	void SetOnHoverDelegate(const FGetUIStateDelegate& GetUIState_OnHover);
 
 	// Logic for determining what UI state should be set on Focus
-	UPROPERTY()
-	FGetUIStateDelegate OnFocusDelegate;
 	UFUNCTION(BlueprintPure)
 	virtual FGameplayTag GetFocusStateFor(const AActor* Interactor) const;
 	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: GetUIState_OnFocus"))
 	void SetOnFocusDelegate(const FGetUIStateDelegate& GetUIState_OnFocus);
 
 	// Logic for determining what UI state should be set when neither Hovered or Focused
-	UPROPERTY()
-	FGetUIStateDelegate GetDefaultStateDelegate;
 	UFUNCTION(BlueprintPure)
 	virtual FGameplayTag GetDefaultStateForLocalPlayer() const;
 	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: GetUIState_DefaultState"))
 	void SetGetDefaultStateDelegate(const FGetUIStateDelegate& GetUIState_DefaultState);
 
-	// Logic for determining what UI state should be set when neither Hovered or Focused
-	UPROPERTY()
-	FOnUIStateChangedDelegate OnUIStateChangedDelegate;
+	// Conveys the UI state once it changes
 	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: OnUIStateChanged"))
 	virtual void SetOnUIStateChangedDelegate(const FOnUIStateChangedDelegate& OnUIStateChanged);
 
+	////////////////////////////////////////
+	//// Native fast path. Checked before the dynamic delegates above, which remain the fallback.
+	///		C++ subclasses can also override GetHoverStateFor, GetFocusStateFor, GetDefaultStateForLocalPlayer
+	///		and OnUIStateChange directly to skip both.
+
+	void SetOnHoverNativeDelegate(FGetUIStateNativeDelegate GetUIState_OnHover) { GetOrAddHandlers().OnHoverNative = MoveTemp(GetUIState_OnHover); InvalidateUIStateCache(); }
+	void SetOnFocusNativeDelegate(FGetUIStateNativeDelegate GetUIState_OnFocus) { GetOrAddHandlers().OnFocusNative = MoveTemp(GetUIState_OnFocus); InvalidateUIStateCache(); }
+	void SetGetDefaultStateNativeDelegate(FGetUIStateNativeDelegate GetUIState_DefaultState) { GetOrAddHandlers().GetDefaultStateNative = MoveTemp(GetUIState_DefaultState); InvalidateUIStateCache(); }
+	void SetOnUIStateChangedNativeDelegate(FOnUIStateChangedNativeDelegate OnUIStateChanged) { GetOrAddHandlers().OnUIStateChangedNative = MoveTemp(OnUIStateChanged); }
+
+	// Everything bound through the setters above, empty if nothing is
+	const FOGInteractableHandlers& GetHandlers() const;
+
 	//// End Interaction Candidate handles
 	//////////////////////////////////////
 #pragma endregion UIStateChange_Delegates
 
+#pragma region ConveyanceProfile
+	////////////////////////////////////////
+	//// Shared conveyance, used for any of the above handlers that this instance has not bound
+
+	UFUNCTION(BlueprintCallable)
+	void SetConveyanceProfile(TSubclassOf<UOGInteractableConveyanceProfile> InConveyanceProfile);
+	const UOGInteractableConveyanceProfile* GetConveyanceProfile() const;
+
+	// Every Interactable with the same profile shares its class default object, nothing is copied per instance
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSubclassOf<UOGInteractableConveyanceProfile> ConveyanceProfile;
+
+	//// End ConveyanceProfile
+	////////////////////////////////////////
+#pragma endregion ConveyanceProfile
+
 #pragma region Behavior_Delegates
 	////////////////////////////////////////
 	//// Begin Behavior Delegates, CanInteract, & Interaction Outcomes
 
-	UPROPERTY()
-	FOnChangeStateNotificationDelegate OnDisabledChangedDelegate;
 	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: OnDisabledChanged"))
 	void SetOnDisabledChangedDelegate(const FOnChangeStateNotificationDelegate& OnDisabledChanged);
 	
@@ -203,6 +319,22 @@ public:
 	const FGameplayTag& SetUIState(const FGameplayTag& NewState);
 	const FGameplayTag& GetUIState() const { return UIState; }
 
+	// Applied once this has left the local view during a callout pass, see UOGInteractionConveyanceSubsystem::RequestCalloutRefresh.
+	// Leave empty to keep whatever state it had
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTag CulledUIState;
+
+	// Opt-in memoization of GetHoverStateFor, GetFocusStateFor and GetDefaultStateForLocalPlayer, per interactor.
+	// Dropped by InvalidateUIStateCache, by rebinding the getters or changing bDisabled, and by
+	// UOGInteractionConveyanceSubsystem::InvalidateUIStateDependency on any of UIStateDependencies
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bCacheUIStates = false;
+	// Tokens for the game state the getters read (e.g., Inventory, Quest.Crafting). A token also covers its children
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagContainer UIStateDependencies;
+	UFUNCTION(BlueprintCallable)
+	void InvalidateUIStateCache() { ++UIStateCacheVersion; }
+
 	UFUNCTION(BlueprintPure)
 	UPrimitiveComponent* GetExpectedOuter() const { return Cast<UPrimitiveComponent>(GetOuter()); }
 
@@ -211,6 +343,10 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	TObjectPtr<UMeshComponent> PhysicalRepresentation;
 
+	// The primitive that interactors query against: the QueryVolume if provided, otherwise the PhysicalRepresentation
+	UFUNCTION(BlueprintPure)
+	UPrimitiveComponent* GetQueryTarget() const;
+
 protected:
 	FName ComponentId;
 	
@@ -220,12 +356,87 @@ protected:
 	// We need to reliably trigger bDisabledUpdates, so it is the only OnRep controlled property
 	UFUNCTION()
 	void OnRep_OnDisabledChanged();
+	// Applies bDisabled locally, for the replicated writes and for the server's own or predicted changes
+	void HandleDisabledChanged();
 
-private:
 	TOGPromise<void> WhenInitialized;
-	
+
+	// Assigned by the server, or locally for Interactables that only exist on this client
+	UPROPERTY(ReplicatedUsing="OnRep_Handle")
+	FOGInteractableHandle Handle;
+
+	UFUNCTION()
+	void OnRep_Handle(const FOGInteractableHandle& PreviousHandle);
+
+	UPROPERTY(ReplicatedUsing="OnRep_NetState")
+	uint8 NetState = 0;
+
+	UFUNCTION()
+	void OnRep_NetState();
+
+	// Whether everything this class replicates fits in an AOGInteractableStateManager item
+	virtual bool CanReplicateStateThroughManager() const { return true; }
+
+	// (Client) Evaluate CanInteract locally and apply the predicted outcome, false if this Interactable doesn't predict InputAction
+	virtual bool PredictInteraction(AActor* Interactor, const FGameplayTag& InputAction) { return false; }
+	// (Client) Undo whatever PredictInteraction did beyond PredictDisabled and the UI state, which are rolled back for you
+	virtual void RollbackInteraction(AActor* Interactor, const FGameplayTag& InputAction) {}
+
+	// (Server) Call before changing a replicated property, so a dormant owner sends the change
+	void FlushOwnerDormancy() const;
+
+private:
+	void AcquireHandle();
+
+	// (Server) Moves this Interactable's replication to its level's state manager
+	void RegisterWithStateManager();
+	// (Client) Called by the state manager with this Interactable's replicated values
+	void ApplyManagedState(const FOGInteractableHandle& InHandle, bool bInDisabled, uint8 InNetState);
+	TWeakObjectPtr<AOGInteractableStateManager> StateManager;
+	friend struct FOGInteractableStateItem;
+
 	// This is not initialized until first hover
 	FGameplayTag UIState;
+	// The state OnUIStateChanged was last called with. Differs from UIState while a coalesced change is pending
+	FGameplayTag BroadcastUIState;
+	// Set while queued in the UOGInteractionConveyanceSubsystem
+	bool bUIStateChangePending = false;
+	// Callout pass bookkeeping: the refresh request this last evaluated its default state for, and whether it was in view
+	uint32 CalloutEpoch = 0;
+	bool bInCalloutView = false;
+	// Queued for a budgeted default state refresh
+	bool bDefaultUIStateDirty = false;
+
+	// Predicted interactions awaiting the server
+	int32 NumPendingPredictions = 0;
+	bool bDisabledPredicted = false;
+	// bDisabled as the server last wrote it, including writes that land during a prediction. What a rollback restores
+	bool bLastServerDisabled = false;
+
+	enum class EUIStateQuery : uint8
+	{
+		Hover,
+		Focus,
+		Default,
+	};
+	// Evaluate's result, or the cached one when bCacheUIStates is set and nothing it depends on has changed
+	FGameplayTag GetCachedUIState(EUIStateQuery Query, const AActor* Interactor, TFunctionRef<FGameplayTag()> Evaluate) const;
+
+	struct FUIStateCacheKey
+	{
+		TObjectKey<AActor> Interactor;
+		int32 Item = INDEX_NONE;
+		EUIStateQuery Query = EUIStateQuery::Default;
+
+		bool operator==(const FUIStateCacheKey& Other) const { return Interactor == Other.Interactor && Item == Other.Item && Query == Other.Query; }
+		friend uint32 GetTypeHash(const FUIStateCacheKey& Key) { return HashCombine(GetTypeHash(Key.Interactor), HashCombine(::GetTypeHash(Key.Item), uint32(Key.Query))); }
+	};
+	mutable TMap<FUIStateCacheKey, FGameplayTag> CachedUIStates;
+	// The versions CachedUIStates were evaluated at
+	mutable uint32 CachedUIStatesVersion = 0;
+	mutable uint32 CachedUIStatesDependencyVersion = 0;
+	uint32 UIStateCacheVersion = 0;
+	friend class UOGInteractionConveyanceSubsystem;
 
 	// Begin Unreal Listeners - Volume based interaction
 	UFUNCTION()
@@ -252,10 +463,24 @@ private:
 	void HandleCursorOverEnd(UPrimitiveComponent* TouchedComponent);
 	// End Unreal Listeners
 
-	// Alerts owner and broadcasts to listeners
-	void OnUIStateChange() const;
+	// Records the state being broadcast, then calls OnUIStateChange
+	void DispatchUIStateChange();
+
+	// Allocated by the first bound handler. Dynamic delegates only hold their object weakly, so this needs no GC reporting
+	TUniquePtr<FOGInteractableHandlers> Handlers;
+	FOGInteractableHandlers& GetOrAddHandlers();
 	
 protected:
-	FGameplayTag TryExecuteGetterDelegate(const FGetUIStateDelegate& InDelegate, const AActor* Interactor, FString CallingFunction) const;
+	// Alerts owner and broadcasts to listeners
+	virtual void OnUIStateChange() const;
+
+	// Whether there is something to evaluate and convey the default state, so Initialize can apply it immediately
+	virtual bool CanRefreshDefaultUIState() const;
+
+	// Distinguishes cached UI states of the items sharing this component, e.g., instances
+	virtual int32 GetUIStateCacheItem() const { return INDEX_NONE; }
+
+	FGameplayTag TryExecuteGetterDelegate(const FGetUIStateDelegate& InDelegate, const AActor* Interactor, const TCHAR* CallingFunction) const;
+	FGameplayTag TryExecuteGetterDelegate(const FGetUIStateNativeDelegate& InNativeDelegate, const FGetUIStateDelegate& InDelegate, const AActor* Interactor, const TCHAR* CallingFunction) const;
 
 };
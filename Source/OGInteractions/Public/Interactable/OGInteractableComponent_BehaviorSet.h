@@ -4,7 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "GameplayTagContainer.h"
 #include "Interactable/OGInteractable_BehaviorSet_Helpers.h"
+#include "UObject/ObjectKey.h"
 #include "OGInteractableComponent_BehaviorSet.generated.h"
 
 DECLARE_DYNAMIC_DELEGATE_RetVal_OneParam(bool, FCanInteractDelegate, const AActor*, Interactor);
@@ -17,10 +19,41 @@ struct OGINTERACTIONS_API FOGInteractableComponent_BehaviorSet_Base
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FCanInteractDelegate CanInteractDelegate;
+
+	// Remembers CanInteract per interactor, so UI checks while hovering and the server's validation share one evaluation.
+	// A result is reused until InvalidateCanInteractCache, a change to the interactor's owned gameplay tags (if bCanInteractDependsOnInteractorTags),
+	// or UOGInteractionConveyanceSubsystem::InvalidateUIStateDependency on one of CanInteractDependencies
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bCacheCanInteract = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bCanInteractDependsOnInteractorTags = true;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagContainer CanInteractDependencies;
 	
 	bool TryExecuteDelegate_CanInteract(AActor* Interactor) const;
 
+	void InvalidateCanInteractCache() { ++CanInteractCacheVersion; }
+	uint32 GetCanInteractCacheHits() const { return CanInteractCacheHits; }
+	uint32 GetCanInteractCacheMisses() const { return CanInteractCacheMisses; }
+
 	FName AssociatedComponentId;
+
+private:
+	struct FCachedCanInteract
+	{
+		// Compared exactly, a hash collision would let a stale result through the server's validation
+		FGameplayTagContainer InteractorTags;
+		uint32 DependencyVersion = 0;
+		bool bCanInteract = false;
+	};
+	mutable TMap<TObjectKey<AActor>, FCachedCanInteract> CachedCanInteract;
+	// The version CachedCanInteract was filled at
+	mutable uint32 CachedCanInteractVersion = 0;
+	// Entries for destroyed interactors are dropped once the cache grows to this size
+	mutable int32 CachedCanInteractPruneAt = 16;
+	uint32 CanInteractCacheVersion = 0;
+	mutable uint32 CanInteractCacheHits = 0;
+	mutable uint32 CanInteractCacheMisses = 0;
 };
 
 /*
@@ -45,7 +78,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
 	FOnInteractionEventDelegate OnInteract_FailedDelegate;
 
+	// (Client) Predicted interactions: the immediate local outcome (e.g., PredictDisabled, an opening animation) while the server decides
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+	FOnInteractionEventDelegate OnInteract_PredictedDelegate;
+
+	// (Client) The server rejected the prediction, undo anything OnInteract_Predicted did beyond PredictDisabled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+	FOnInteractionEventDelegate OnInteract_RolledBackDelegate;
+
 public:
 	DECLARE_INTERACTION_EVENT_DELEGATE_DEFINITION(OnInteract_Succeeded);
 	DECLARE_INTERACTION_EVENT_DELEGATE_DEFINITION(OnInteract_Failed);
+	DECLARE_INTERACTION_EVENT_DELEGATE_DEFINITION(OnInteract_Predicted);
+	DECLARE_INTERACTION_EVENT_DELEGATE_DEFINITION(OnInteract_RolledBack);
 };
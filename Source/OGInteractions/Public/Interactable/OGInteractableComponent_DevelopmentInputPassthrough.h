@@ -34,10 +34,30 @@ public:
 	UFUNCTION(BlueprintCallable, Server, Reliable)
 	void TryInteract(AActor* Interactor, const FGameplayTag& InputAction);
 
+	// Requests through UOGInteractorComponent::RequestInteraction land here, same as TryInteract
+	virtual bool HandleInteractionRequest(AActor* Interactor, const FGameplayTag& InputAction) override;
+
 	UFUNCTION(BlueprintCallable)
 	void BindTriggeredAction(FGameplayTag InputAction, FOGInteractableComponent_BehaviorSet_Triggered TriggeredBinding);
 
+	// The CanInteract result TryInteract would act on, through the behavior's cache if it has bCacheCanInteract set
+	UFUNCTION(BlueprintPure)
+	bool CanInteract(AActor* Interactor, const FGameplayTag& InputAction) const;
+
+	// Drops the cached CanInteract results of InputAction's behavior, or of every behavior if InputAction is empty
+	UFUNCTION(BlueprintCallable)
+	void InvalidateCanInteract(FGameplayTag InputAction);
+
+	// Summed over every bound behavior
+	UFUNCTION(BlueprintPure)
+	void GetCanInteractCacheCounters(int32& OutHits, int32& OutMisses) const;
+
 protected:
+	// Runs the behavior's OnInteract_Predicted if CanInteract passes locally
+	virtual bool PredictInteraction(AActor* Interactor, const FGameplayTag& InputAction) override;
+	// Runs the behavior's OnInteract_RolledBack
+	virtual void RollbackInteraction(AActor* Interactor, const FGameplayTag& InputAction) override;
+
 	// In the event you want to bind different types of interactions (e.g., Ongoing) you'll need a second storage solution
 	TMap<FGameplayTag, FOGInteractableComponent_BehaviorSet_Triggered> InteractBehaviors;
 };
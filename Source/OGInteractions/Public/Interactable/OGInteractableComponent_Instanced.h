@@ -0,0 +1,129 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OGInteractableComponent_Base.h"
+#include "OGInteractableComponent_Instanced.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnInstanceUIStateChangedDelegate, int32, InstanceIndex, const FGameplayTag&, NewUIState);
+
+/*
+ * One Interactable for every instance of an (H)ISM, rather than one component per prop.
+ * Hits resolve FHitResult::Item to an instance index, and hover, focus, disabled and UI state are tracked per instance.
+ *
+ * Conveyance is written to the instance's custom data (see UIStateCustomDataValues), so a material can react without
+ * any Blueprint call. OnInstanceUIStateChanged may also be bound for anything custom data can't express.
+ *
+ * The UI state getters are shared by every instance, call GetEvaluatingInstance from within them to know which one is asked for.
+ * Instance indices are expected to be stable, removing instances from the ISM is not tracked.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class OGINTERACTIONS_API UOGInteractableComponent_Instanced : public UOGInteractableComponent_Base
+{
+	GENERATED_BODY()
+
+protected:
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+public:
+	/**
+	 * @brief Initialize against an (H)ISM, which is used as the PhysicalRepresentation and queried per instance
+	 * @param Id A Unique tag to identify this OGInteractableComponent from others on the same actor.
+	 * @param InInstances The instances that are interactable. Needs collision that blocks the interaction channel.
+	 * @param VisualDelegates Container for optional visual to pass into the InteractionComponent.
+	 */
+	UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="VisualDelegates", AdvancedDisplay="VisualDelegates"))
+	void InitializeInstanced(FName Id, UInstancedStaticMeshComponent* InInstances,
+		const FOGInteractableComponent_VisualDelegates& VisualDelegates
+	);
+
+	UFUNCTION(BlueprintPure)
+	UInstancedStaticMeshComponent* GetInstances() const;
+
+	// Custom data float that receives the instance's UI state value, INDEX_NONE to not write one
+	UPROPERTY(EditDefaultsOnly)
+	int32 UIStateCustomDataIndex = 0;
+
+	// Value written to UIStateCustomDataIndex for each UI state. States not in the map write 0
+	UPROPERTY(EditDefaultsOnly)
+	TMap<FGameplayTag, float> UIStateCustomDataValues;
+
+	// Custom data float that receives 1 while the instance is disabled, INDEX_NONE to not write one
+	UPROPERTY(EditDefaultsOnly)
+	int32 DisabledCustomDataIndex = INDEX_NONE;
+
+	/**
+	 * @brief (Server) Disables a single instance, it can no longer become a candidate
+	 */
+	UFUNCTION(BlueprintCallable, Server, Reliable)
+	void SetInstanceDisabled(int32 InstanceIndex, bool bInDisabled);
+
+	UFUNCTION(BlueprintPure)
+	bool GetIsInstanceDisabled(int32 InstanceIndex) const;
+
+	UFUNCTION(BlueprintPure)
+	FGameplayTag GetInstanceUIState(int32 InstanceIndex) const;
+
+	UFUNCTION(BlueprintPure)
+	int32 GetHoveredInstance() const { return HoveredInstance; }
+	UFUNCTION(BlueprintPure)
+	int32 GetFocusedInstance() const { return FocusedInstance; }
+
+	// The instance whose UI state is currently being evaluated, for use inside the GetUIState delegates
+	UFUNCTION(BlueprintPure)
+	int32 GetEvaluatingInstance() const { return EvaluatingInstance; }
+
+	// Re-evaluates a single instance, as TriggerUIStateDefaultRefresh does for all of them
+	UFUNCTION(BlueprintCallable)
+	void TriggerInstanceUIStateDefaultRefresh(int32 InstanceIndex);
+
+	// Called after an instance's UI state (and custom data) changed
+	UPROPERTY()
+	FOnInstanceUIStateChangedDelegate OnInstanceUIStateChangedDelegate;
+	UFUNCTION(BlueprintCallable, meta=(DisplayName="Set Delegate: OnInstanceUIStateChanged"))
+	void SetOnInstanceUIStateChangedDelegate(const FOnInstanceUIStateChangedDelegate& OnInstanceUIStateChanged);
+
+	virtual void TriggerUIStateDefaultRefresh() override;
+
+	virtual void TriggerHoverForItem(const AActor* InInstigator, int32 Item) override;
+	virtual void TriggerHoverEndForItem(const AActor* InInstigator, int32 Item) override;
+	virtual void TriggerFocusForItem(const AActor* InInstigator, int32 Item) override;
+	virtual void TriggerFocusEndForItem(const AActor* InInstigator, int32 Item) override;
+
+	virtual int32 GetInteractionItem(const FHitResult& HitResult) const override;
+	virtual bool IsItemDisabled(int32 Item) const override;
+
+protected:
+	// Conveyance is per instance, the component level UI state only reaches OnUIStateChanged if one was bound
+	virtual void OnUIStateChange() const override;
+	virtual bool CanRefreshDefaultUIState() const override;
+	virtual int32 GetUIStateCacheItem() const override { return EvaluatingInstance; }
+	// InstanceDisabledFlags still replicates on the component
+	virtual bool CanReplicateStateThroughManager() const override { return false; }
+
+	UFUNCTION()
+	void OnRep_InstanceDisabledFlags();
+
+	// 1 for every disabled instance. Replicated as a whole, only the instances that differ from AppliedDisabledFlags are refreshed
+	UPROPERTY(ReplicatedUsing="OnRep_InstanceDisabledFlags")
+	TArray<uint8> InstanceDisabledFlags;
+
+private:
+	// Grows the per-instance arrays to the ISM's current instance count
+	void SyncInstanceCount();
+
+	// Evaluates the default/hover/focus state of one instance for the local player
+	FGameplayTag GetInstanceStateFor(int32 InstanceIndex, const AActor* Interactor);
+	void SetInstanceUIState(int32 InstanceIndex, const FGameplayTag& NewState);
+	void ApplyInstanceDisabled(int32 InstanceIndex, bool bInDisabled);
+
+	TArray<FGameplayTag> InstanceUIStates;
+	TArray<uint8> AppliedDisabledFlags;
+
+	int32 HoveredInstance = INDEX_NONE;
+	int32 FocusedInstance = INDEX_NONE;
+	int32 EvaluatingInstance = INDEX_NONE;
+};
@@ -0,0 +1,40 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/Object.h"
+#include "OGInteractableConveyanceProfile.generated.h"
+
+class UOGInteractableComponent_Base;
+
+/*
+ * Shared conveyance for many Interactables: the same handlers as FOGInteractableComponent_VisualDelegates,
+ * but implemented once on a class and referenced by every Interactable that uses it, rather than bound per instance.
+ *
+ * Interactables use the profile's class default object, so there is nothing to create or bind on spawn.
+ * The Interactable is passed to each handler so one profile can serve any number of them.
+ * Delegates bound on an individual Interactable still take priority, overriding the profile for that instance only.
+ */
+UCLASS(Abstract, Blueprintable)
+class OGINTERACTIONS_API UOGInteractableConveyanceProfile : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintNativeEvent)
+	FGameplayTag GetHoverState(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const;
+
+	UFUNCTION(BlueprintNativeEvent)
+	FGameplayTag GetFocusState(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const;
+
+	UFUNCTION(BlueprintNativeEvent)
+	FGameplayTag GetDefaultState(const UOGInteractableComponent_Base* Interactable, const AActor* Interactor) const;
+
+	UFUNCTION(BlueprintNativeEvent)
+	void OnUIStateChanged(UOGInteractableComponent_Base* Interactable, const FGameplayTag& NewUIState) const;
+
+	UFUNCTION(BlueprintNativeEvent)
+	void OnDisabledChanged(UOGInteractableComponent_Base* Interactable, bool bNewDisabled) const;
+};
@@ -4,10 +4,55 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "OGFuture.h"
+#include "WorldCollision.h"
+#include "Utilities/OGInteractableHandle.h"
 #include "Utilities/OGInteractionTags.h"
 #include "OGInteractorComponent.generated.h"
 
 class UOGInteractableComponent_Base;
+class UOGInteractableRegistrySubsystem;
+
+UENUM(BlueprintType)
+enum class EOGInteractorTraceMode : uint8
+{
+	// Trace on the game thread inside TickComponent, the candidate is updated the same frame
+	Synchronous,
+	// Submit the trace to the physics scene and consume the result on the next frame (one frame of hover latency)
+	Asynchronous,
+	// Ray query against the registry's BVH of box/sphere/capsule QueryVolumes, off the physics scene.
+	// World geometry does not block it, and Interactables queried through a mesh are not in it
+	InteractableBVH,
+};
+
+// One interaction asked of the server, see UOGInteractorComponent::RequestInteraction
+USTRUCT()
+struct OGINTERACTIONS_API FOGInteractionRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FOGInteractableHandle Handle;
+	// Sent as its tag net index
+	UPROPERTY()
+	FGameplayTag InputAction;
+	// Non-zero for UOGInteractorComponent::PredictInteraction, the server answers it with an FOGPredictedInteractionResult
+	UPROPERTY()
+	uint16 PredictionId = 0;
+};
+
+USTRUCT()
+struct OGINTERACTIONS_API FOGPredictedInteractionResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint16 PredictionId = 0;
+	UPROPERTY()
+	bool bConfirmed = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnPredictedInteractionResolved, UOGInteractableComponent_Base*, Interactable, FGameplayTag, InputAction, bool, bConfirmed);
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class OGINTERACTIONS_API UOGInteractorComponent : public UActorComponent
@@ -18,6 +63,7 @@ public:
 	// Sets default values for this component's properties
 	UOGInteractorComponent();
 
+	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	UPROPERTY(EditDefaultsOnly)
@@ -26,23 +72,201 @@ public:
 	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::Raycast()"))
 	float RaycastRange = 600.f;
 
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::Raycast()"))
+	EOGInteractorTraceMode TraceMode = EOGInteractorTraceMode::Synchronous;
+
+	// For non-player interactors (AI): query through UOGInteractionQuerySubsystem's time-sliced batch instead of tracing every tick.
+	// The ray starts at the owner's eye viewpoint rather than a camera, and the candidate is kept without any conveyance
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::Raycast()"))
+	bool bBatchedQueries = false;
+
+	// Skip the trace while the view is still and nothing in range has changed
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::Raycast()"))
+	bool bMotionGatedTrace = false;
+
+	// How far (cm) the view has to move from the last trace before tracing again
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bMotionGatedTrace", ClampMin=0))
+	float MotionGateLocationThreshold = 1.f;
+
+	// How far (degrees) the view has to turn from the last trace before tracing again
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bMotionGatedTrace", ClampMin=0))
+	float MotionGateAngleThreshold = 0.5f;
+
+	// Traces per second will never exceed this, even while moving. 0 traces every tick
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bMotionGatedTrace", ClampMin=0))
+	float MaxTraceRate = 0.f;
+
+	// Traces per second will never drop below this, even while still. 0 only traces on motion or invalidation
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bMotionGatedTrace", ClampMin=0))
+	float MinTraceRate = 1.f;
+
+	// PawnOverlap: find the overlap set each tick from the registry's proximity grid instead of physics overlap events,
+	// so Interactables don't need overlap events (or any pawn collision response) at all
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::PawnOverlap()"))
+	bool bOverlapFromProximityGrid = false;
+
+	// PawnOverlap with bOverlapFromProximityGrid: how close (cm) an Interactable's bounds must come to the owner to count as overlapping
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bOverlapFromProximityGrid", ClampMin=0))
+	float ProximityOverlapRadius = 150.f;
+
+	// PawnOverlap: how strongly facing away from an overlapped interactable counts against it, relative to distance
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::PawnOverlap()", ClampMin=0))
+	float OverlapViewAngleWeight = 1.f;
+
+	// PawnOverlap: overlapped interactables further than this (degrees) from the view direction can't become the candidate
+	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="InteractionTriggerType == InteractionSystem::InteractionTrigger::PawnOverlap()", ClampMin=0, ClampMax=180))
+	float OverlapMaxViewAngle = 180.f;
+
+	// Forces the next motion-gated tick to trace
+	UFUNCTION(BlueprintCallable)
+	void InvalidateTrace() { bTraceInvalidated = true; }
+
+	// Item identifies a sub-target of multi-target Interactables (e.g., an instance index), INDEX_NONE otherwise
 	virtual UOGInteractableComponent_Base* GetInteractionFocus() { return InteractionFocus; };
-	virtual void SetInteractionFocus(UOGInteractableComponent_Base* NewInteractable);
+	virtual void SetInteractionFocus(UOGInteractableComponent_Base* NewInteractable, int32 Item = INDEX_NONE);
 	virtual void RemoveInteractionFocus(UOGInteractableComponent_Base* OldInteractable);
 	virtual UOGInteractableComponent_Base* GetInteractionFocus() const;
 	virtual void ClearInteractionFocus();
+	int32 GetInteractionFocusItem() const { return InteractionFocusItem; }
 
 	virtual UOGInteractableComponent_Base* GetInteractionCandidate() { return InteractionCandidate; };
-	virtual void SetInteractionCandidate(UOGInteractableComponent_Base* NewInteractable);
+	virtual void SetInteractionCandidate(UOGInteractableComponent_Base* NewInteractable, int32 Item = INDEX_NONE);
 	virtual void RemoveInteractionCandidate(UOGInteractableComponent_Base* OldInteractable);
 	virtual UOGInteractableComponent_Base* GetInteractionCandidate() const;
 	virtual void ClearInteractionCandidate();
+	int32 GetInteractionCandidateItem() const { return InteractionCandidateItem; }
+
+	// PawnOverlap: the overlap set changed, the candidate is re-picked from it
+	virtual void AddOverlapCandidate(UOGInteractableComponent_Base* Interactable);
+	virtual void RemoveOverlapCandidate(UOGInteractableComponent_Base* Interactable);
+
+	/**
+	 * @brief Asks the server to interact with Interactable, which receives it in HandleInteractionRequest.
+	 * Requests made in the same frame go out together in one RPC, and the server drops any past its
+	 * OG.Interactions.RequestRate budget before resolving them. Call on the owning client (or the server)
+	 */
+	UFUNCTION(BlueprintCallable)
+	void RequestInteraction(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction);
+
+	/**
+	 * @brief RequestInteraction, with the outcome applied locally right away (see UOGInteractableComponent_Base::PredictInteraction).
+	 * The future resolves once the server confirms or rejects, or after OG.Interactions.PredictionTimeout. A rejection rolls back the
+	 * predicted disabled and UI state, OnPredictedInteractionResolved says which it was.
+	 * If CanInteract fails locally nothing is sent, and it resolves rejected immediately. On the server it is a plain request
+	 */
+	FOGFuture PredictInteraction(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnPredictedInteractionResolved OnPredictedInteractionResolved;
 
 protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUnregister() override;
+
+	UFUNCTION(Server, Reliable)
+	void ServerRequestInteractions(const TArray<FOGInteractionRequest>& Requests);
+
+	UFUNCTION(Client, Reliable)
+	void ClientResolvePredictedInteractions(const TArray<FOGPredictedInteractionResult>& Results);
+
+	// (Server) Resolves each request that fits the rate budget and hands it to its Interactable
+	void ProcessInteractionRequests(const TArray<FOGInteractionRequest>& Requests);
+
+	// The component the interaction ray is cast from (the owner's camera), cached after the first lookup
+	USceneComponent* GetViewSource();
+
+	// Only the local player's interactor triggers hover/focus conveyance, other pawns (AI, remote players) only track their candidate
+	bool ConveysUIState() const;
+
+	bool ShouldTraceFrom(const FVector& ViewLocation, const FVector& ViewDirection) const;
+	bool UsesOverlapCandidates() const { return InteractionTriggerType == OccamsGamkit::Interactions::PawnOverlap; }
+	// Picks the best of the overlapped interactables by distance and view angle
+	void SelectOverlapCandidate();
+	// bOverlapFromProximityGrid: replaces the overlap set with the grid's, re-picking only if it changed
+	void RefreshProximityOverlapCandidates();
+	void HandleInteractableChanged(UOGInteractableComponent_Base* Interactable);
+
+	// Updates the candidate from a trace outcome, HitResult is null when nothing was hit
+	void HandleTraceResult(const FHitResult* HitResult);
+
+	void SubmitAsyncTrace(const FVector& StartTrace, const FVector& EndTrace);
+	void HandleAsyncTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
 	// What is currently "Selected" or "Focused" in UI Parlance
 	UPROPERTY(BlueprintReadWrite)
 	TObjectPtr<UOGInteractableComponent_Base> InteractionFocus = nullptr;
 	// What is currently "Hovered" in UI Parlance
 	UPROPERTY(BlueprintReadWrite)
 	TObjectPtr<UOGInteractableComponent_Base> InteractionCandidate = nullptr;
+	UPROPERTY(BlueprintReadOnly)
+	int32 InteractionFocusItem = INDEX_NONE;
+	UPROPERTY(BlueprintReadOnly)
+	int32 InteractionCandidateItem = INDEX_NONE;
+
+	// Resolves hit components to their Interactable, cached on BeginPlay
+	UPROPERTY(Transient)
+	TObjectPtr<UOGInteractableRegistrySubsystem> InteractableRegistry = nullptr;
+
+private:
+	friend class UOGInteractionQuerySubsystem;
+
+	TWeakObjectPtr<USceneComponent> CachedViewSource;
+
+	// Motion gate state, from the last trace that was actually performed
+	FVector LastTraceLocation = FVector::ZeroVector;
+	FVector LastTraceDirection = FVector::ZeroVector;
+	double LastTraceTime = -UE_BIG_NUMBER;
+	bool bTraceInvalidated = true;
+	FDelegateHandle InteractableChangedHandle;
+
+	// PawnOverlap: every interactable currently overlapping the owner
+	TArray<TWeakObjectPtr<UOGInteractableComponent_Base>> OverlapCandidates;
+	// Reused by RefreshProximityOverlapCandidates
+	TArray<UOGInteractableComponent_Base*> ProximityScratch;
+
+	// The in-flight Asynchronous trace, results for any other handle are stale and discarded
+	FTraceHandle PendingTraceHandle;
+	// Who was controlling the owner when the pending trace was submitted
+	TWeakObjectPtr<AController> PendingTraceController;
+	FTraceDelegate AsyncTraceDelegate;
+
+	// Built once in BeginPlay so tracing doesn't rebuild the ignore list every frame
+	FCollisionQueryParams TraceQueryParams;
+
+	// bBatchedQueries: only the server, or the client controlling the owner, has a candidate worth querying for
+	bool ShouldRunBatchedQueries() const;
+	// Registers with UOGInteractionQuerySubsystem and stops ticking, false if this interactor shouldn't query (yet)
+	bool TryRegisterBatchedQueries();
+
+	// Sends the frame's requests once every actor has ticked
+	void FlushInteractionRequests(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	// (Server) Token bucket, false once this interactor is over its request rate
+	bool ConsumeRequestToken();
+
+	TArray<FOGInteractionRequest> PendingInteractionRequests;
+	// Swapped with PendingInteractionRequests while sending, so requests raised during processing wait for the next frame
+	TArray<FOGInteractionRequest> SendingInteractionRequests;
+	FDelegateHandle FlushInteractionRequestsHandle;
+	// Starts full, clamped to the burst size on first use
+	float RequestTokens = TNumericLimits<float>::Max();
+	double LastRequestTokenTime = 0.0;
+
+	struct FPendingPrediction
+	{
+		uint16 PredictionId = 0;
+		TWeakObjectPtr<UOGInteractableComponent_Base> Interactable;
+		FGameplayTag InputAction;
+		double ExpireTime = 0.0;
+		// False on the server, where the request resolves without having predicted anything
+		bool bPredicted = false;
+		TOGPromise<void> WhenResolved;
+	};
+	// Oldest first, they all share one timeout
+	TArray<FPendingPrediction> PendingPredictions;
+	uint16 NextPredictionId = 0;
+	FTimerHandle PredictionTimeoutTimer;
+
+	// Rolls back a rejection, and resolves the prediction's future
+	void ResolvePrediction(int32 Index, bool bConfirmed);
+	void ExpirePredictions();
 };
@@ -0,0 +1,108 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Utilities/OGInteractableHandle.h"
+#include "OGInteractableStateManager.generated.h"
+
+class AOGInteractableStateManager;
+class UOGInteractableComponent_Base;
+struct FOGInteractableStateArray;
+
+// The replicated state of one Interactable that replicates through an AOGInteractableStateManager
+USTRUCT()
+struct OGINTERACTIONS_API FOGInteractableStateItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UOGInteractableComponent_Base> Interactable;
+	UPROPERTY()
+	FOGInteractableHandle Handle;
+	UPROPERTY()
+	bool bDisabled = false;
+	UPROPERTY()
+	uint8 NetState = 0;
+
+	void PostReplicatedAdd(const FOGInteractableStateArray& InArraySerializer);
+	void PostReplicatedChange(const FOGInteractableStateArray& InArraySerializer);
+
+private:
+	// (Client) Hands the replicated values to the Interactable, once its reference has resolved
+	void Apply() const;
+};
+
+USTRUCT()
+struct OGINTERACTIONS_API FOGInteractableStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FOGInteractableStateItem> Items;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FOGInteractableStateItem, FOGInteractableStateArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FOGInteractableStateArray> : public TStructOpsTypeTraitsBase2<FOGInteractableStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/*
+ * Replicates bDisabled, NetState and the handle of every Interactable in its level that has bReplicateStateThroughManager set,
+ * as one fast array: only the Interactables that changed are compared and sent, and the Interactables themselves don't replicate.
+ *
+ * Spawned by UOGInteractableRegistrySubsystem on the server, one per level, the first time one of its Interactables asks for it.
+ * With OG.Interactions.StateManagerCellSize set there is one per level and grid cell instead, only relevant to viewers within
+ * OG.Interactions.StateRelevancyRadius, through UOGReplicationGraphNode_InteractableState or the actor's net cull distance.
+ */
+UCLASS(NotPlaceable, Transient)
+class OGINTERACTIONS_API AOGInteractableStateManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOGInteractableStateManager();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// (Server)
+	void AddInteractable(UOGInteractableComponent_Base* Interactable);
+	void RemoveInteractable(UOGInteractableComponent_Base* Interactable);
+	// (Server) Sends Interactable's current bDisabled and NetState
+	void MarkInteractableDirty(UOGInteractableComponent_Base* Interactable);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumInteractables() const { return States.Items.Num(); }
+
+	// (Server) Before spawning finishes, turns this into the manager of one grid cell, only relevant within RelevancyRadius of it.
+	// Spawn it at GetCellCenter
+	static FVector GetCellCenter(const FIntPoint& InCell, double InCellSize) { return FVector((InCell.X + 0.5) * InCellSize, (InCell.Y + 0.5) * InCellSize, 0.0); }
+	void InitializeCell(const FIntPoint& InCell, double InCellSize, double RelevancyRadius);
+	bool IsSpatial() const { return bSpatial; }
+	const FIntPoint& GetCell() const { return Cell; }
+	double GetCellSize() const { return CellSize; }
+	double GetRelevancyRadius() const { return CellRelevancyRadius; }
+
+private:
+	FIntPoint Cell = FIntPoint::ZeroValue;
+	double CellSize = 0.0;
+	double CellRelevancyRadius = 0.0;
+	bool bSpatial = false;
+
+	UPROPERTY(Replicated)
+	FOGInteractableStateArray States;
+
+	// (Server) Index of each Interactable's item in States
+	TMap<TObjectKey<UOGInteractableComponent_Base>, int32> ItemIndices;
+};
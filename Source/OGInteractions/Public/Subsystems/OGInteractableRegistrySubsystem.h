@@ -0,0 +1,186 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Utilities/OGInteractableBVH.h"
+#include "Utilities/OGInteractableHandle.h"
+#include "OGInteractableRegistrySubsystem.generated.h"
+
+class AOGInteractableStateManager;
+class UOGInteractableComponent_Base;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOGOnInteractableChanged, UOGInteractableComponent_Base* /*Interactable*/);
+
+// Per-world activity counters, see OG.Interactions.DumpStats
+USTRUCT(BlueprintType)
+struct OGINTERACTIONS_API FOGInteractionsWorldStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 TracesLastFrame = 0;
+	UPROPERTY(BlueprintReadOnly)
+	int32 StateTransitionsLastFrame = 0;
+	UPROPERTY(BlueprintReadOnly)
+	int64 TotalTraces = 0;
+	UPROPERTY(BlueprintReadOnly)
+	int64 TotalStateTransitions = 0;
+	// Interactor ticks: the raycast, or the proximity grid overlap refresh. Event driven PawnOverlap doesn't tick and isn't counted.
+	// Both timers are only recorded in builds with stats or the CSV profiler
+	UPROPERTY(BlueprintReadOnly)
+	float InteractorTickMsLastFrame = 0.f;
+	UPROPERTY(BlueprintReadOnly)
+	float ResolveMsLastFrame = 0.f;
+
+	int32 TracesThisFrame = 0;
+	int32 StateTransitionsThisFrame = 0;
+	uint64 InteractorTickCyclesThisFrame = 0;
+	uint64 ResolveCyclesThisFrame = 0;
+};
+
+/*
+ * Per-world lookup from the primitive that an interactor queries against (QueryVolume or PhysicalRepresentation)
+ * back to the InteractableComponent that owns it.
+ *
+ * UOGInteractableComponent_Base::Initialize registers here, so resolving a hit is a single hash lookup
+ * rather than a scan of ComponentTags and the hit actor's components.
+ *
+ * Registered query targets are also kept in a hashed proximity grid (OG.Interactions.ProximityGridCellSize),
+ * updated on registration and when they move, so nearby Interactables can be found without a physics overlap.
+ */
+UCLASS()
+class OGINTERACTIONS_API UOGInteractableRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UOGInteractableRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterInteractable(UOGInteractableComponent_Base* Interactable, UPrimitiveComponent* QueryTarget);
+	void UnregisterInteractable(UOGInteractableComponent_Base* Interactable, UPrimitiveComponent* QueryTarget);
+
+	// Returns the Interactable whose query primitive is QueryTarget, or nullptr if it is not registered
+	UFUNCTION(BlueprintPure)
+	UOGInteractableComponent_Base* FindInteractable(const UPrimitiveComponent* QueryTarget) const;
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumRegisteredInteractables() const { return QueryTargetToInteractable.Num(); }
+
+	// Every Interactable whose query target bounds come within Radius of Location, answered from the proximity grid
+	UFUNCTION(BlueprintCallable)
+	void GetInteractablesInRadius(const FVector& Location, float Radius, TArray<UOGInteractableComponent_Base*>& OutInteractables, bool bIncludeDisabled = false) const;
+
+	// Calls Visitor for every registered Interactable and its query target. Don't register or unregister from within it
+	void ForEachInteractable(TFunctionRef<void(UOGInteractableComponent_Base& Interactable, const UPrimitiveComponent& QueryTarget)> Visitor) const;
+
+	// Hands out a new handle for Interactable. Local handles come from a separate table, for Interactables the server doesn't know about
+	FOGInteractableHandle AllocateHandle(UOGInteractableComponent_Base* Interactable, bool bLocal);
+	// Clients: binds a server assigned handle to the local copy of its Interactable
+	void BindReplicatedHandle(const FOGInteractableHandle& Handle, UOGInteractableComponent_Base* Interactable);
+	void ReleaseHandle(const FOGInteractableHandle& Handle);
+
+	// Only compares generations, so it is safe to call with handles held across frames
+	bool IsHandleValid(const FOGInteractableHandle& Handle) const;
+	UFUNCTION(BlueprintPure)
+	UOGInteractableComponent_Base* ResolveHandle(const FOGInteractableHandle& Handle) const;
+
+	// Starts maintaining an FOGInteractableBVH of every registered box, sphere and capsule QueryVolume. Off until something asks for it
+	void EnableInteractableBVH();
+	// Null until EnableInteractableBVH. Queries on it are thread safe
+	const FOGInteractableBVH* GetInteractableBVH() const { return InteractableBVH.Get(); }
+	// Ray query against the BVH, OutHit is filled like a physics trace's
+	bool RaycastInteractableBVH(const FVector& Start, const FVector& End, FHitResult& OutHit);
+	// Game thread, resolves the hit's QueryTarget
+	static bool MakeHitResult(const FOGInteractableBVHHit& Hit, const FVector& Start, const FVector& End, FHitResult& OutHit);
+
+	// (Server) The AOGInteractableStateManager replicating the Interactables of Level (and of Location's cell, with
+	// OG.Interactions.StateManagerCellSize set), spawned on first use
+	AOGInteractableStateManager* FindOrSpawnStateManager(ULevel* Level, const FVector& Location);
+
+	// Broadcast when a registered Interactable changes in a way that may alter query results (its query target moved, or it was enabled/disabled)
+	FOGOnInteractableChanged OnInteractableChanged;
+	void NotifyInteractableChanged(UOGInteractableComponent_Base* Interactable);
+
+	// Instrumentation, counted per world as well as in STATGROUP_OGInteractions
+	void RecordTrace();
+	void RecordStateTransition();
+	void RecordInteractorTickTime(uint64 Cycles);
+	void RecordResolveTime(uint64 Cycles);
+	UFUNCTION(BlueprintPure)
+	const FOGInteractionsWorldStats& GetWorldStats() const { return WorldStats; }
+
+	// Records the per-frame counters for NumFrames, then writes them as JSON to Saved/Profiling/OGInteractions
+	void StartStatsCapture(int32 NumFrames);
+	bool IsCapturingStats() const { return StatsCaptureFramesRemaining > 0; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void WriteStatsCapture();
+	void HandleQueryTargetMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	struct FRegisteredInteractable
+	{
+		TWeakObjectPtr<UOGInteractableComponent_Base> Interactable;
+		FDelegateHandle TransformUpdatedHandle;
+		FIntVector ProximityCell = FIntVector::ZeroValue;
+		bool bInProximityGrid = false;
+		// In OversizedProximityTargets rather than a cell
+		bool bProximityOversized = false;
+	};
+	TMap<TObjectKey<UPrimitiveComponent>, FRegisteredInteractable> QueryTargetToInteractable;
+
+	FIntVector GetProximityCell(const FVector& Location) const;
+	void UpdateProximityGrid(const UPrimitiveComponent* QueryTarget, FRegisteredInteractable& Entry);
+	void RemoveFromProximityGrid(const TObjectKey<UPrimitiveComponent>& Key, FRegisteredInteractable& Entry);
+
+	// Query targets by the cell of their bounds origin
+	TMap<FIntVector, TArray<TObjectKey<UPrimitiveComponent>, TInlineAllocator<4>>> ProximityGrid;
+	double ProximityCellSize = 500.0;
+	// Targets with a bounds radius over half a cell, scanned by every query so the rest only reach half a cell further
+	TArray<TObjectKey<UPrimitiveComponent>> OversizedProximityTargets;
+
+	struct FHandleSlot
+	{
+		TWeakObjectPtr<UOGInteractableComponent_Base> Interactable;
+		uint32 Generation = 0;
+		bool bOccupied = false;
+	};
+	struct FHandleTable
+	{
+		TArray<FHandleSlot> Slots;
+		TArray<uint32> FreeIndices;
+	};
+	FHandleTable NetworkedHandles;
+	FHandleTable LocalHandles;
+	FHandleTable& GetHandleTable(bool bLocal) { return bLocal ? LocalHandles : NetworkedHandles; }
+	const FHandleTable& GetHandleTable(bool bLocal) const { return bLocal ? LocalHandles : NetworkedHandles; }
+	const FHandleSlot* FindHandleSlot(const FOGInteractableHandle& Handle) const;
+
+	TUniquePtr<FOGInteractableBVH> InteractableBVH;
+
+	// By level and cell, the cell is always zero without OG.Interactions.StateManagerCellSize
+	TMap<TPair<TObjectKey<ULevel>, FIntPoint>, TWeakObjectPtr<AOGInteractableStateManager>> StateManagers;
+	double StateManagerCellSize = 0.0;
+
+	FOGInteractionsWorldStats WorldStats;
+
+	struct FStatsCaptureFrame
+	{
+		int32 Traces = 0;
+		int32 StateTransitions = 0;
+		float InteractorTickMs = 0.f;
+		float ResolveMs = 0.f;
+	};
+	TArray<FStatsCaptureFrame> StatsCaptureFrames;
+	int32 StatsCaptureFramesRemaining = 0;
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,129 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OGInteractionConveyanceSubsystem.generated.h"
+
+class UOGInteractableComponent_Base;
+struct FConvexVolume;
+struct FMinimalViewInfo;
+
+/*
+ * Schedules client-side conveyance (OnUIStateChanged) for the Interactables in a world.
+ *
+ * With OG.Interactions.CoalesceUIStateChanges enabled, SetUIState only records the change and the subsystem
+ * dispatches once per component at the end of the frame with its final state.
+ * E.g., Default -> Hover -> Default within one frame makes no call at all, rather than two.
+ *
+ * It also runs the callout pass: after RequestCalloutRefresh, every frame the registered Interactables are tested against
+ * the local view frustum (and OG.Interactions.CalloutCullDistance), and only those in view re-evaluate their default state.
+ * Interactables that leave the view are demoted a few at a time (OG.Interactions.CalloutDemotionsPerFrame) to their CulledUIState.
+ *
+ * MarkInteractablesDirty spreads a bulk default state refresh (e.g., on a quest step) over as many frames as
+ * OG.Interactions.DirtyRefreshBudgetMs needs, Interactables in the local view first, then by distance.
+ */
+UCLASS()
+class OGINTERACTIONS_API UOGInteractionConveyanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UOGInteractionConveyanceSubsystem* Get(const UObject* WorldContextObject);
+
+	// Whether UI state changes are currently being batched to the end of the frame
+	static bool IsCoalescingUIStateChanges();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Records that Interactable's UI state changed, it will be dispatched when the frame is flushed
+	void QueueUIStateChange(UOGInteractableComponent_Base* Interactable);
+
+	// Dispatches every pending UI state change. Called automatically at the end of the frame
+	void FlushUIStateChanges();
+
+	// Transitions that never reached OnUIStateChanged because a later change in the same frame superseded them
+	UFUNCTION(BlueprintPure)
+	int64 GetElidedTransitionCount() const { return TotalElidedTransitions; }
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameElidedTransitionCount() const { return LastFrameElidedTransitions; }
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameDispatchedTransitionCount() const { return LastFrameDispatchedTransitions; }
+
+	// Re-evaluates the default UI state of every Interactable, e.g., after changing what your callouts highlight.
+	// With OG.Interactions.CalloutCulling on, each one is only evaluated once it is in the local view
+	UFUNCTION(BlueprintCallable)
+	void RequestCalloutRefresh();
+
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameVisibleCalloutCount() const { return LastFrameVisibleCallouts; }
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameCalloutRefreshCount() const { return LastFrameCalloutRefreshes; }
+
+	// Queues a default state refresh for every Interactable with any of FilterTags in its InteractableTags, and of FilterClass.
+	// Empty filters match everything. Drained at the end of each frame under OG.Interactions.DirtyRefreshBudgetMs
+	UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="FilterTags"))
+	void MarkInteractablesDirty(const FGameplayTagContainer& FilterTags, TSubclassOf<UOGInteractableComponent_Base> FilterClass = nullptr);
+	void MarkInteractableDirty(UOGInteractableComponent_Base* Interactable);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumDirtyInteractables() const { return DirtyInteractables.Num() - NextDirtyInteractable; }
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameDirtyRefreshCount() const { return LastFrameDirtyRefreshes; }
+
+	// Drops the cached UI states (see UOGInteractableComponent_Base::bCacheUIStates) of every Interactable
+	// that lists Token, or one of its children, in its UIStateDependencies
+	UFUNCTION(BlueprintCallable)
+	void InvalidateUIStateDependency(FGameplayTag Token);
+	// Changes whenever one of Dependencies, or one of their parents, is invalidated
+	uint32 GetUIStateDependencyVersion(const FGameplayTagContainer& Dependencies) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void UpdateCalloutVisibility();
+	void DrainCalloutDemotions(const AActor* LocalPawn);
+	void SortDirtyInteractables();
+	void DrainDirtyInteractables();
+	// The first local player's view. False without one, e.g., on a dedicated server
+	bool GetLocalView(FMinimalViewInfo& OutView, FConvexVolume& OutFrustum) const;
+
+	// Two buffers, so changes raised while flushing land in the next frame without reallocating
+	TArray<TWeakObjectPtr<UOGInteractableComponent_Base>> PendingUIStateChanges;
+	TArray<TWeakObjectPtr<UOGInteractableComponent_Base>> FlushingUIStateChanges;
+
+	int32 ElidedTransitionsThisFrame = 0;
+	int32 LastFrameElidedTransitions = 0;
+	int32 LastFrameDispatchedTransitions = 0;
+	int64 TotalElidedTransitions = 0;
+
+	// Bumped by RequestCalloutRefresh, 0 until callouts are first requested
+	uint32 CalloutEpoch = 0;
+	// Scratch for the visibility pass, structure of arrays padded to a multiple of 4 for the vectorized test
+	TArray<UOGInteractableComponent_Base*> CalloutInteractables;
+	TArray<double> CalloutX;
+	TArray<double> CalloutY;
+	TArray<double> CalloutZ;
+	TArray<double> CalloutRadius;
+	// Left the view, waiting to be demoted
+	TArray<TWeakObjectPtr<UOGInteractableComponent_Base>> PendingCalloutDemotions;
+
+	int32 LastFrameVisibleCallouts = 0;
+	int32 LastFrameCalloutRefreshes = 0;
+
+	// Refreshed front to back, entries before NextDirtyInteractable are done
+	TArray<TWeakObjectPtr<UOGInteractableComponent_Base>> DirtyInteractables;
+	int32 NextDirtyInteractable = 0;
+	bool bDirtyInteractablesNeedSort = false;
+	int32 LastFrameDirtyRefreshes = 0;
+
+	// Times each token was invalidated. Their sum over a set of tokens only ever grows, so it works as that set's version
+	TMap<FGameplayTag, uint32> UIStateDependencyVersions;
+
+	FDelegateHandle PostActorTickHandle;
+};
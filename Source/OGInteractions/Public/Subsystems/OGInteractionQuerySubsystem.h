@@ -0,0 +1,68 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utilities/OGInteractableBVH.h"
+#include "OGInteractionQuerySubsystem.generated.h"
+
+class UOGInteractorComponent;
+
+/*
+ * Runs the interaction queries of non-player interactors (AI, typically on the server) in one batch per frame,
+ * rather than each of them tracing in its own tick.
+ *
+ * Interactors with bBatchedQueries register on BeginPlay and are visited round-robin:
+ *	- Queries are gathered on the game thread in chunks, traced across worker threads with ParallelFor,
+ *	  then resolved on the game thread through the interactor's usual SetInteractionCandidate path
+ *	- Chunks stop once OG.Interactions.BatchedQueryBudgetMs is spent, the rest carry over to the next frame
+ */
+UCLASS()
+class OGINTERACTIONS_API UOGInteractionQuerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UOGInteractionQuerySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterInteractor(UOGInteractorComponent* Interactor);
+	void UnregisterInteractor(UOGInteractorComponent* Interactor);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumInteractors() const { return Interactors.Num(); }
+	// How many interactors were queried last frame, out of GetNumInteractors
+	UFUNCTION(BlueprintPure)
+	int32 GetLastFrameQueryCount() const { return LastFrameQueryCount; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FBatchedQuery
+	{
+		TWeakObjectPtr<UOGInteractorComponent> Interactor;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		const FCollisionQueryParams* QueryParams = nullptr;
+		bool bUseBVH = false;
+		bool bHit = false;
+		FHitResult HitResult;
+		FOGInteractableBVHHit BVHHit;
+	};
+
+	// Game thread, reads the interactor's eye viewpoint
+	bool BuildQuery(UOGInteractorComponent* Interactor, FBatchedQuery& OutQuery) const;
+
+	TArray<TWeakObjectPtr<UOGInteractorComponent>> Interactors;
+	int32 NextInteractor = 0;
+	int32 LastFrameQueryCount = 0;
+
+	// Reused every chunk
+	TArray<FBatchedQuery> Batch;
+};
@@ -0,0 +1,103 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+
+class UPrimitiveComponent;
+class UShapeComponent;
+
+struct FOGInteractableBVHHit
+{
+	TObjectKey<UPrimitiveComponent> QueryTarget;
+	double Distance = 0.0;
+	FVector Location = FVector::ZeroVector;
+};
+
+/*
+ * Bounding volume hierarchy over the box, sphere and capsule QueryVolumes of a world's Interactables,
+ * so interaction queries don't go through the physics scene (and its lock) at all.
+ *
+ * Only Interactable shapes are in here, world geometry does not occlude a hit.
+ *
+ * Owned by UOGInteractableRegistrySubsystem, which feeds it on the game thread:
+ *	- Moved shapes refit their ancestors' bounds in place, leaves are padded so small motions don't refit at all
+ *	- Added shapes are scanned linearly until the next Rebuild, removed ones are skipped until then
+ * Raycast and ConeQuery only take a read lock, so they can be called from worker threads.
+ */
+class OGINTERACTIONS_API FOGInteractableBVH
+{
+public:
+	// Returns false if Shape isn't a box, sphere or capsule
+	bool AddShape(const UShapeComponent* Shape, bool bDisabled);
+	void RemoveShape(const UPrimitiveComponent* Shape);
+	void UpdateShape(const UShapeComponent* Shape);
+	void SetShapeDisabled(const UPrimitiveComponent* Shape, bool bDisabled);
+
+	// Rebuilds the tree from every live shape. Game thread, blocks queries while running
+	void Rebuild();
+	bool NeedsRebuild() const;
+	int32 Num() const;
+
+	// Closest enabled shape along the segment
+	bool Raycast(const FVector& Start, const FVector& End, FOGInteractableBVHHit& OutHit) const;
+	// Enabled shapes whose bounding sphere is within MaxDistance and HalfAngleDegrees of the ray, closest first
+	void ConeQuery(const FVector& Origin, const FVector& Direction, double MaxDistance, float HalfAngleDegrees, TArray<FOGInteractableBVHHit>& OutHits) const;
+
+private:
+	enum class EShape : uint8
+	{
+		Box,
+		Sphere,
+		Capsule,
+	};
+
+	struct FLeaf
+	{
+		TObjectKey<UPrimitiveComponent> QueryTarget;
+		FQuat Rotation = FQuat::Identity;
+		FVector Center = FVector::ZeroVector;
+		// Box: half extents. Sphere: X is the radius. Capsule: X is the radius, Z the half height including the caps
+		FVector Extent = FVector::ZeroVector;
+		// Padded bounds the tree was fitted to
+		FBox FatBounds = FBox(ForceInit);
+		int32 NodeIndex = INDEX_NONE;
+		EShape Shape = EShape::Box;
+		bool bDisabled = false;
+		bool bRemoved = false;
+	};
+
+	struct FNode
+	{
+		VectorRegister4Double Min;
+		VectorRegister4Double Max;
+		int32 Parent = INDEX_NONE;
+		// Internal: the right child, the left child is always the next node. Leaf: the first entry in LeafOrder
+		int32 ChildOrFirst = INDEX_NONE;
+		// 0 for internal nodes
+		int32 NumLeaves = 0;
+	};
+
+	static bool ReadShape(const UShapeComponent* Shape, FLeaf& OutLeaf);
+	static FBox CalcBounds(const FLeaf& Leaf);
+	static bool RaycastLeaf(const FLeaf& Leaf, const VectorRegister4Double& Start, const VectorRegister4Double& Direction, double MaxDistance, double& OutDistance);
+
+	int32 BuildRecursive(int32 Parent, int32 First, int32 Count, TArray<FVector>& Centroids);
+	void RefitFrom(int32 NodeIndex, const FBox& Bounds);
+	bool IsQueryable(const FLeaf& Leaf) const { return !Leaf.bDisabled && !Leaf.bRemoved; }
+
+	TArray<FLeaf> Leaves;
+	TMap<TObjectKey<UPrimitiveComponent>, int32> LeafByTarget;
+	TArray<FNode> Nodes;
+	// Leaf indices, grouped so every tree leaf node owns a contiguous range
+	TArray<int32> LeafOrder;
+	// Added since the last Rebuild, not in the tree yet
+	TArray<int32> PendingLeaves;
+	int32 NumRemoved = 0;
+	int32 NumRefits = 0;
+
+	mutable FRWLock Lock;
+};
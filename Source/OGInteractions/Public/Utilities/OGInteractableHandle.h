@@ -0,0 +1,58 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OGInteractableHandle.generated.h"
+
+/*
+ * Compact, generation-checked reference to a registered Interactable, allocated by UOGInteractableRegistrySubsystem.
+ *
+ * Packed into 32 bits: [31] local, [30..20] generation, [19..0] slot index.
+ *	- Server assigned handles replicate, so the same value names the same Interactable on every machine
+ *	- Client-only Interactables get a local handle from a separate table, which never goes over the wire
+ * A freed slot bumps its generation, so a stale handle fails to resolve instead of naming whatever reused the slot.
+ */
+USTRUCT(BlueprintType)
+struct OGINTERACTIONS_API FOGInteractableHandle
+{
+	GENERATED_BODY()
+
+	static constexpr uint32 IndexBits = 20;
+	static constexpr uint32 GenerationBits = 11;
+	static constexpr uint32 MaxIndex = (1u << IndexBits) - 1;
+	static constexpr uint32 MaxGeneration = (1u << GenerationBits) - 1;
+
+	FOGInteractableHandle() = default;
+	FOGInteractableHandle(uint32 InIndex, uint32 InGeneration, bool bInLocal);
+
+	// Generation 0 is never handed out, so a zero value is always invalid
+	bool IsValid() const { return GetGeneration() != 0; }
+	uint32 GetIndex() const { return Value & MaxIndex; }
+	uint32 GetGeneration() const { return (Value >> IndexBits) & MaxGeneration; }
+	bool IsLocal() const { return (Value >> 31) != 0; }
+	uint32 GetValue() const { return Value; }
+
+	bool operator==(const FOGInteractableHandle& Other) const { return Value == Other.Value; }
+	bool operator!=(const FOGInteractableHandle& Other) const { return Value != Other.Value; }
+	friend uint32 GetTypeHash(const FOGInteractableHandle& Handle) { return Handle.Value; }
+
+	// Index and generation are packed separately, so the handles of a typical level fit in two or three bytes
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	FString ToString() const;
+
+private:
+	UPROPERTY()
+	uint32 Value = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FOGInteractableHandle> : public TStructOpsTypeTraitsBase2<FOGInteractableHandle>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
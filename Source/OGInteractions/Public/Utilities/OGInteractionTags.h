@@ -6,6 +6,7 @@ namespace OccamsGamkit
 	namespace Interactions
 	{
 		UE_DECLARE_GAMEPLAY_TAG_EXTERN(Raycast);
+		UE_DECLARE_GAMEPLAY_TAG_EXTERN(PawnOverlap);
 
 		namespace InteractableComponent
 		{
@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/*
+ * Instrumentation for the plugin.
+ *	- `stat OGInteractions` for the in-game stat group
+ *	- Unreal Insights picks up the OG_INTERACTIONS_SCOPE cpu scopes, and the OGInteractions counters
+ *	- CSV profiles get an OGInteractions category with per-frame traces and state transitions
+ *	- `OG.Interactions.DumpStats` prints the per-world counters
+ *	- `OG.Interactions.CaptureStats [NumFrames]` writes them, with memory per interactable, as JSON to Saved/Profiling/OGInteractions
+ */
+
+DECLARE_STATS_GROUP(TEXT("OGInteractions"), STATGROUP_OGInteractions, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interactor Trace"), STAT_OGInteractions_InteractorTrace, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batched Queries"), STAT_OGInteractions_BatchedQueries, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Hit"), STAT_OGInteractions_ResolveHit, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get UI State"), STAT_OGInteractions_GetUIState, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnUIStateChange"), STAT_OGInteractions_OnUIStateChange, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnRep_OnDisabledChanged"), STAT_OGInteractions_OnRepDisabledChanged, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryInteract"), STAT_OGInteractions_TryInteract, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Callout Visibility"), STAT_OGInteractions_CalloutVisibility, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dirty Refresh"), STAT_OGInteractions_DirtyRefresh, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_OGInteractions_Traces, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("State Transitions"), STAT_OGInteractions_StateTransitions, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("UI State Cache Hits"), STAT_OGInteractions_UIStateCacheHits, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("UI State Cache Misses"), STAT_OGInteractions_UIStateCacheMisses, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CanInteract Cache Hits"), STAT_OGInteractions_CanInteractCacheHits, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CanInteract Cache Misses"), STAT_OGInteractions_CanInteractCacheMisses, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Dropped Interaction Requests"), STAT_OGInteractions_DroppedRequests, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Interactables"), STAT_OGInteractions_RegisteredInteractables, STATGROUP_OGInteractions, OGINTERACTIONS_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(OGINTERACTIONS_API, OGInteractions);
+
+// Times the enclosing scope for both the stat group and Unreal Insights
+#define OG_INTERACTIONS_SCOPE(StatName) \
+	SCOPE_CYCLE_COUNTER(StatName); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(StatName)
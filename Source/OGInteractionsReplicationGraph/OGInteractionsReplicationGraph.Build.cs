@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class OGInteractionsReplicationGraph : ModuleRules
+{
+	public OGInteractionsReplicationGraph(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// The node's header derives from UReplicationGraphNode
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"ReplicationGraph",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"NetCore",
+				"OGInteractions",
+			}
+			);
+	}
+}
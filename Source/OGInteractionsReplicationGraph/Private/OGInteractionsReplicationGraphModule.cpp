@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// Replication Graph support for OGInteractions, only needed by projects that use the ReplicationGraph plugin
+IMPLEMENT_MODULE(FDefaultModuleImpl, OGInteractionsReplicationGraph)
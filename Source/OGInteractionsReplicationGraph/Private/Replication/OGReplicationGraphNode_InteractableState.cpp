@@ -0,0 +1,90 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Replication/OGReplicationGraphNode_InteractableState.h"
+
+#include "Replication/OGInteractableStateManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOccamsGamekit_InteractionsReplicationGraph, Warning, All);
+
+bool UOGReplicationGraphNode_InteractableState::RoutesActor(const AActor* Actor)
+{
+	const auto* Manager = Cast<AOGInteractableStateManager>(Actor);
+	return Manager && Manager->IsSpatial();
+}
+
+void UOGReplicationGraphNode_InteractableState::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const auto* Manager = Cast<AOGInteractableStateManager>(ActorInfo.Actor);
+	if (!ensureAlwaysMsgf(Manager && Manager->IsSpatial(), TEXT("UOGReplicationGraphNode_InteractableState::NotifyAddNetworkActor - %s is not a cell state manager"), *GetNameSafe(ActorInfo.Actor)))
+		return;
+
+	CellSize = Manager->GetCellSize();
+	RelevancyRadius = FMath::Max(RelevancyRadius, Manager->GetRelevancyRadius());
+	ManagersByCell.FindOrAdd(Manager->GetCell()).Add(ActorInfo.Actor);
+}
+
+bool UOGReplicationGraphNode_InteractableState::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const auto* Manager = Cast<AOGInteractableStateManager>(ActorInfo.Actor);
+	FActorRepListRefView* Managers = Manager ? ManagersByCell.Find(Manager->GetCell()) : nullptr;
+	const bool bRemoved = Managers && Managers->RemoveFast(ActorInfo.Actor);
+	if (!bRemoved && bWarnIfNotFound)
+	{
+		UE_LOG(LogOccamsGamekit_InteractionsReplicationGraph, Warning, TEXT("UOGReplicationGraphNode_InteractableState::NotifyRemoveNetworkActor - %s was not in the node"), *GetNameSafe(ActorInfo.Actor));
+	}
+	return bRemoved;
+}
+
+void UOGReplicationGraphNode_InteractableState::NotifyResetAllNetworkActors()
+{
+	ManagersByCell.Reset();
+	Super::NotifyResetAllNetworkActors();
+}
+
+void UOGReplicationGraphNode_InteractableState::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (ManagersByCell.Num() == 0 || CellSize <= 0.0)
+		return;
+
+	const double RelevancyRadiusSquared = FMath::Square(RelevancyRadius);
+	// Split screen viewers may share cells, each is only gathered once. A single viewer visits each cell once anyway
+	const bool bDeduplicateCells = Params.Viewers.Num() > 1;
+	TSet<FIntPoint> GatheredCells;
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FVector2D ViewLocation(Viewer.ViewLocation.X, Viewer.ViewLocation.Y);
+		const int32 MinX = FMath::FloorToInt32((ViewLocation.X - RelevancyRadius) / CellSize);
+		const int32 MaxX = FMath::FloorToInt32((ViewLocation.X + RelevancyRadius) / CellSize);
+		const int32 MinY = FMath::FloorToInt32((ViewLocation.Y - RelevancyRadius) / CellSize);
+		const int32 MaxY = FMath::FloorToInt32((ViewLocation.Y + RelevancyRadius) / CellSize);
+
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			for (int32 Y = MinY; Y <= MaxY; ++Y)
+			{
+				const FIntPoint Cell(X, Y);
+				const FActorRepListRefView* Managers = ManagersByCell.Find(Cell);
+				if (!Managers || Managers->Num() == 0)
+					continue;
+
+				// Distance to the closest point of the cell, the square around the viewer over-reaches at its corners
+				const FVector2D Closest(
+					FMath::Clamp(ViewLocation.X, X * CellSize, (X + 1) * CellSize),
+					FMath::Clamp(ViewLocation.Y, Y * CellSize, (Y + 1) * CellSize)
+				);
+				if (FVector2D::DistSquared(Closest, ViewLocation) > RelevancyRadiusSquared)
+					continue;
+
+				if (bDeduplicateCells)
+				{
+					bool bAlreadyGathered = false;
+					GatheredCells.Add(Cell, &bAlreadyGathered);
+					if (bAlreadyGathered)
+						continue;
+				}
+				Params.OutGatheredReplicationLists.AddReplicationActorList(*Managers);
+			}
+		}
+	}
+}
@@ -0,0 +1,39 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "OGReplicationGraphNode_InteractableState.generated.h"
+
+/*
+ * Replication Graph node for the cell state managers (see OG.Interactions.StateManagerCellSize).
+ * A connection only gathers the managers of cells within OG.Interactions.StateRelevancyRadius of one of its viewers,
+ * so a far away SetDisabled is neither serialized for, nor considered by, that connection.
+ *
+ * Lives in the OGInteractionsReplicationGraph module, add it to your game module's dependencies. In your UReplicationGraph subclass:
+ *	- InitGlobalGraphNodes: CreateNewNode<UOGReplicationGraphNode_InteractableState>(), then AddGlobalGraphNode it
+ *	- RouteAddNetworkActorToNodes/RouteRemoveNetworkActorToNodes: hand it every actor RoutesActor accepts
+ *	- Per-level managers (no cell size) are always relevant, route those to your always relevant node instead
+ */
+UCLASS()
+class OGINTERACTIONSREPLICATIONGRAPH_API UOGReplicationGraphNode_InteractableState : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	// Whether Actor belongs in this node, i.e., is a cell AOGInteractableStateManager
+	static bool RoutesActor(const AActor* Actor);
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	// Managers of every level, by cell
+	TMap<FIntPoint, FActorRepListRefView> ManagersByCell;
+	// Taken from the managers, they all share the registry's cell size
+	double CellSize = 0.0;
+	double RelevancyRadius = 0.0;
+};
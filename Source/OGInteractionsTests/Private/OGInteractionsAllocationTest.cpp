@@ -0,0 +1,85 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Misc/AutomationTest.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestAllocations.h"
+#include "OGInteractionsTestWorld.h"
+#include "Utilities/OGInteractionTags.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+ * Counts heap allocations on the hover path: trace -> resolve -> SetInteractionCandidate -> TriggerHover -> SetUIState.
+ * The interactor is ticked by hand inside the counter so the rest of the world's tick isn't counted with it
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOGInteractionsHoverAllocationTest, "OGInteractions.Allocations.Hover",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FOGInteractionsHoverAllocationTest::RunTest(const FString& Parameters)
+{
+	// A hover transition may allocate at most this many times, e.g., a delegate payload. Holding a hover may not allocate at all
+	constexpr uint64 MaxTransitionAllocations = 4;
+	constexpr int32 NumSteadyStateFrames = 120;
+	constexpr int32 NumTransitions = 20;
+	namespace UIState = OccamsGamkit::Interactions::Examples::UIState;
+
+	FOGInteractionsTestWorld TestWorld;
+	auto* Interactable = TestWorld.SpawnInteractable(FVector(300.0, 0.0, 0.0), EOGTestInteractableConfig::QueryVolume);
+	auto* Pawn = TestWorld.SpawnInteractor(FVector::ZeroVector, FRotator::ZeroRotator);
+	UOGInteractorComponent* Interactor = Pawn->Interactor;
+	Interactor->SetComponentTickEnabled(false);
+
+	const FRotator LookAt = FRotator::ZeroRotator;
+	const FRotator LookAway(0.0, 90.0, 0.0);
+	auto TickInteractor = [&]()
+	{
+		Interactor->TickComponent(1.f / 60.f, LEVELTICK_All, nullptr);
+	};
+
+	// Let everything that sizes itself lazily (handler caches, the trace's scratch) do so before counting
+	TestWorld.Tick(5);
+	for (int32 Warmup = 0; Warmup < 4; ++Warmup)
+	{
+		Pawn->SetActorRotation(Warmup % 2 ? LookAway : LookAt);
+		TickInteractor();
+		TestWorld.Tick();
+	}
+	Pawn->SetActorRotation(LookAt);
+	TickInteractor();
+	if (!TestEqual(TEXT("Hovering the Interactable"), Interactable->GetUIState(), UIState::Hover.GetTag()))
+		return false;
+
+	uint64 SteadyStateAllocations = 0;
+	for (int32 Frame = 0; Frame < NumSteadyStateFrames; ++Frame)
+	{
+		TestWorld.Tick();
+		FOGScopedAllocationCounter Allocations;
+		TickInteractor();
+		SteadyStateAllocations += Allocations.GetNumAllocations();
+	}
+	TestEqual(TEXT("Allocations while holding a hover"), SteadyStateAllocations, static_cast<uint64>(0));
+	TestEqual(TEXT("Still hovering"), Interactable->GetUIState(), UIState::Hover.GetTag());
+
+	uint64 MostTransitionAllocations = 0;
+	for (int32 Transition = 0; Transition < NumTransitions; ++Transition)
+	{
+		const bool bHover = Transition % 2 == 1;
+		Pawn->SetActorRotation(bHover ? LookAt : LookAway);
+		TestWorld.Tick();
+
+		FOGScopedAllocationCounter Allocations;
+		TickInteractor();
+		const uint64 TransitionAllocations = Allocations.GetNumAllocations();
+		Allocations.SetPaused(true);
+
+		MostTransitionAllocations = FMath::Max(MostTransitionAllocations, TransitionAllocations);
+		TestEqual(TEXT("UI state after the transition"), Interactable->GetUIState(), bHover ? UIState::Hover.GetTag() : UIState::None.GetTag());
+	}
+	TestTrue(FString::Printf(TEXT("Allocations per hover transition (%llu) within %llu"), MostTransitionAllocations, MaxTransitionAllocations),
+		MostTransitionAllocations <= MaxTransitionAllocations);
+	return true;
+}
+
+#endif
@@ -0,0 +1,108 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "OGInteractionsTestWorld.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+#include "Utilities/OGInteractions_Types.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+ * The same rays through the Interactable BVH and through LineTraceSingleByChannel, over 1k, 10k and 100k box QueryVolumes.
+ * -OGBenchRays=R (10000) changes how many rays are cast
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FOGInteractionsBVHBenchmark, "OGInteractions.Benchmark.BVH",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FOGInteractionsBVHBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 NumInteractables : { 1000, 10000, 100000 })
+	{
+		OutBeautifiedNames.Add(FString::FromInt(NumInteractables));
+		OutTestCommands.Add(FString::FromInt(NumInteractables));
+	}
+}
+
+bool FOGInteractionsBVHBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumInteractables = FCString::Atoi(*Parameters);
+	int32 NumRays = 10000;
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchRays="), NumRays);
+
+	FOGInteractionsTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	auto* Registry = UOGInteractableRegistrySubsystem::Get(World);
+	if (!TestNotNull(TEXT("Registry"), Registry))
+		return false;
+
+	constexpr double Spacing = 300.0;
+	const int32 GridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<double>(NumInteractables)));
+	for (int32 Index = 0; Index < NumInteractables; ++Index)
+	{
+		TestWorld.SpawnInteractable(FVector((Index % GridSide) * Spacing, (Index / GridSide) * Spacing, 0.0), EOGTestInteractableConfig::QueryVolume);
+	}
+	Registry->EnableInteractableBVH();
+	TestWorld.Tick();
+
+	// Interaction length rays from head height, looking down at the grid in every direction
+	FRandomStream Random(NumInteractables);
+	TArray<TPair<FVector, FVector>> Rays;
+	Rays.Reserve(NumRays);
+	for (int32 Index = 0; Index < NumRays; ++Index)
+	{
+		const FVector Start(Random.FRandRange(0.0, GridSide * Spacing), Random.FRandRange(0.0, GridSide * Spacing), 150.0);
+		const FRotator View(Random.FRandRange(-40.0, 0.0), Random.FRandRange(0.0, 360.0), 0.0);
+		Rays.Emplace(Start, Start + View.Vector() * 600.0);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(OGInteractionsBVHBenchmark), false);
+	int32 PhysicsHits = 0, BVHHits = 0, Agreements = 0;
+	TArray<const UPrimitiveComponent*> PhysicsResults;
+	PhysicsResults.Reserve(NumRays);
+
+	const double PhysicsStart = FPlatformTime::Seconds();
+	for (const TPair<FVector, FVector>& Ray : Rays)
+	{
+		FHitResult Hit;
+		const bool bHit = World->LineTraceSingleByChannel(Hit, Ray.Key, Ray.Value, OG_ECC_INTERACTABLE, QueryParams);
+		PhysicsResults.Add(bHit ? Hit.GetComponent() : nullptr);
+		PhysicsHits += bHit;
+	}
+	const double PhysicsMs = (FPlatformTime::Seconds() - PhysicsStart) * 1000.0;
+
+	const double BVHStart = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < Rays.Num(); ++Index)
+	{
+		FHitResult Hit;
+		const bool bHit = Registry->RaycastInteractableBVH(Rays[Index].Key, Rays[Index].Value, Hit);
+		BVHHits += bHit;
+		Agreements += (bHit ? Hit.GetComponent() : nullptr) == PhysicsResults[Index];
+	}
+	const double BVHMs = (FPlatformTime::Seconds() - BVHStart) * 1000.0;
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Interactables"), NumInteractables);
+	Report->SetNumberField(TEXT("Rays"), NumRays);
+	Report->SetNumberField(TEXT("LineTraceSingleMs"), PhysicsMs);
+	Report->SetNumberField(TEXT("BVHMs"), BVHMs);
+	Report->SetNumberField(TEXT("LineTraceSingleUsPerRay"), PhysicsMs * 1000.0 / FMath::Max(NumRays, 1));
+	Report->SetNumberField(TEXT("BVHUsPerRay"), BVHMs * 1000.0 / FMath::Max(NumRays, 1));
+	Report->SetNumberField(TEXT("LineTraceSingleHits"), PhysicsHits);
+	Report->SetNumberField(TEXT("BVHHits"), BVHHits);
+	Report->SetNumberField(TEXT("Agreements"), Agreements);
+
+	const FString ReportPath = OGInteractionsTests::WriteReport(FString::Printf(TEXT("BVH_%d"), NumInteractables), Report);
+	AddInfo(FString::Printf(TEXT("%d Interactables, %d rays: LineTraceSingle %.3f ms, BVH %.3f ms (%.2fx). %s"),
+		NumInteractables, NumRays, PhysicsMs, BVHMs, PhysicsMs / FMath::Max(BVHMs, UE_SMALL_NUMBER), *ReportPath));
+
+	TestTrue(TEXT("Rays hit Interactables"), PhysicsHits > 0);
+	// Nothing else is in the world to occlude, so only rays grazing an edge may disagree
+	TestTrue(FString::Printf(TEXT("BVH and LineTraceSingle agree on %d of %d rays"), Agreements, NumRays), Agreements >= NumRays * 0.99);
+	TestFalse(TEXT("Report written"), ReportPath.IsEmpty());
+	return true;
+}
+
+#endif
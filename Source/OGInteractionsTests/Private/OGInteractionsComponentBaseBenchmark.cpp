@@ -0,0 +1,102 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestAllocations.h"
+#include "OGInteractionsTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	struct FComponentBaseCost
+	{
+		double BytesPerInstance = 0.0;
+		double AllocationsPerInstance = 0.0;
+		double RegisterUsPerInstance = 0.0;
+	};
+
+	// Creates NumInstances components of Class, each the root of its own actor, and measures creating and registering them
+	FComponentBaseCost MeasureComponentClass(UClass* Class, int32 NumInstances)
+	{
+		FOGInteractionsTestWorld TestWorld;
+		UWorld* World = TestWorld.GetWorld();
+
+		TArray<AActor*> Owners;
+		Owners.Reserve(NumInstances);
+		for (int32 Index = 0; Index < NumInstances; ++Index)
+		{
+			Owners.Add(World->SpawnActor<AActor>());
+		}
+
+		FComponentBaseCost Cost;
+		const double Count = FMath::Max(NumInstances, 1);
+		{
+			FOGScopedAllocationCounter Allocations;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (AActor* Owner : Owners)
+			{
+				auto* Component = NewObject<USceneComponent>(Owner, Class);
+				Owner->SetRootComponent(Component);
+				Component->RegisterComponent();
+			}
+			Cost.RegisterUsPerInstance = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 / Count;
+			Cost.BytesPerInstance = Allocations.GetAllocatedBytes() / Count;
+			Cost.AllocationsPerInstance = Allocations.GetNumAllocations() / Count;
+		}
+		return Cost;
+	}
+}
+
+/*
+ * What the Interactable's parent class costs per instance: a bare PrimitiveComponent (its parent in 1.0),
+ * a bare SceneComponent (its parent now) and the Interactable itself, created and registered 10k times each.
+ * The Interactables aren't initialized, so only the component is measured. -OGBenchInteractables=N changes the count
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOGInteractionsComponentBaseBenchmark, "OGInteractions.Benchmark.ComponentBase",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FOGInteractionsComponentBaseBenchmark::RunTest(const FString& Parameters)
+{
+	int32 NumInstances = 10000;
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchInteractables="), NumInstances);
+
+	const TPair<const TCHAR*, UClass*> Classes[] = {
+		{ TEXT("PrimitiveComponent"), UOGInteractionsTestPrimitiveBase::StaticClass() },
+		{ TEXT("SceneComponent"), UOGInteractionsTestSceneBase::StaticClass() },
+		{ TEXT("Interactable"), UOGInteractableComponent_DevelopmentInputPassthrough::StaticClass() },
+	};
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Instances"), NumInstances);
+	TMap<FString, FComponentBaseCost> Costs;
+	for (const TPair<const TCHAR*, UClass*>& Class : Classes)
+	{
+		const FComponentBaseCost Cost = MeasureComponentClass(Class.Value, NumInstances);
+		Costs.Add(Class.Key, Cost);
+
+		const TSharedRef<FJsonObject> ClassReport = MakeShared<FJsonObject>();
+		ClassReport->SetNumberField(TEXT("ObjectSize"), Class.Value->GetStructureSize());
+		ClassReport->SetNumberField(TEXT("BytesPerInstance"), Cost.BytesPerInstance);
+		ClassReport->SetNumberField(TEXT("AllocationsPerInstance"), Cost.AllocationsPerInstance);
+		ClassReport->SetNumberField(TEXT("RegisterUsPerInstance"), Cost.RegisterUsPerInstance);
+		Report->SetObjectField(Class.Key, ClassReport);
+
+		AddInfo(FString::Printf(TEXT("%s x%d: %d B object, %.0f B and %.1f allocations per instance, %.2f us to register"),
+			Class.Key, NumInstances, Class.Value->GetStructureSize(), Cost.BytesPerInstance, Cost.AllocationsPerInstance, Cost.RegisterUsPerInstance));
+	}
+
+	const FString ReportPath = OGInteractionsTests::WriteReport(FString::Printf(TEXT("ComponentBase_%d"), NumInstances), Report);
+	AddInfo(ReportPath);
+
+	TestTrue(TEXT("A SceneComponent costs less per instance than a PrimitiveComponent"),
+		Costs[TEXT("SceneComponent")].BytesPerInstance < Costs[TEXT("PrimitiveComponent")].BytesPerInstance);
+	TestFalse(TEXT("Report written"), ReportPath.IsEmpty());
+	return true;
+}
+
+#endif
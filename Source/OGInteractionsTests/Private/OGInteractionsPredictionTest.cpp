@@ -0,0 +1,260 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Misc/AutomationTest.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestPIE.h"
+#include "Utilities/OGInteractionTags.h"
+
+#if WITH_EDITOR && WITH_DEV_AUTOMATION_TESTS
+
+namespace OGInteractionsPredictionTest
+{
+	enum class ECase : uint8
+	{
+		// The server accepts, the prediction stands
+		Confirm,
+		// The server refuses, the client rolls back
+		Reject,
+		// The answer is slower than OG.Interactions.PredictionTimeout: rolled back, then the server's state replicates over it
+		Timeout,
+	};
+
+	// Both directions, so requests, answers and replicated state are all late and some are resent
+	constexpr const TCHAR* PacketLag = TEXT("Net PktLag=150");
+	constexpr const TCHAR* PacketLoss = TEXT("Net PktLoss=5");
+
+	struct FPredictionTest
+	{
+		enum class EPhase : uint8
+		{
+			WaitForPIE,
+			Spawn,
+			WaitForClient,
+			WaitForResolution,
+			Settle,
+			Done,
+		};
+
+		ECase Case = ECase::Confirm;
+		EPhase Phase = EPhase::WaitForPIE;
+		double PhaseStartTime = 0.0;
+
+		TWeakObjectPtr<AOGInteractionsTestInteractable> ServerInteractable;
+		TWeakObjectPtr<AOGInteractionsTestInteractable> ClientInteractable;
+		TWeakObjectPtr<AOGInteractionsTestPawn> ClientPawn;
+
+		bool Update(FAutomationTestBase& Test);
+
+	private:
+		void SetPhase(EPhase InPhase) { Phase = InPhase; PhaseStartTime = FPlatformTime::Seconds(); }
+		double GetPhaseTime() const { return FPlatformTime::Seconds() - PhaseStartTime; }
+		bool HasTimedOut(FAutomationTestBase& Test, double Seconds, const TCHAR* Waiting);
+		void CheckOutcome(FAutomationTestBase& Test) const;
+	};
+
+	bool FPredictionTest::HasTimedOut(FAutomationTestBase& Test, double Seconds, const TCHAR* Waiting)
+	{
+		if (GetPhaseTime() < Seconds)
+			return false;
+
+		Test.AddError(FString::Printf(TEXT("Timed out waiting for %s"), Waiting));
+		Phase = EPhase::Done;
+		return true;
+	}
+
+	bool FPredictionTest::Update(FAutomationTestBase& Test)
+	{
+		UWorld* ServerWorld = OGInteractionsTests::FindPIEWorld(NM_ListenServer);
+		UWorld* ClientWorld = OGInteractionsTests::FindPIEWorld(NM_Client);
+		if (Phase != EPhase::WaitForPIE && Phase != EPhase::Done && (!ServerWorld || !ClientWorld))
+		{
+			Test.AddError(TEXT("The play session ended early"));
+			Phase = EPhase::Done;
+		}
+
+		switch (Phase)
+		{
+		case EPhase::WaitForPIE:
+			if (PhaseStartTime == 0.0)
+			{
+				PhaseStartTime = FPlatformTime::Seconds();
+			}
+			else if (OGInteractionsTests::IsListenServerPIEReady())
+			{
+				SetPhase(EPhase::Spawn);
+			}
+			else
+			{
+				HasTimedOut(Test, 60.0, TEXT("the listen server and client"));
+			}
+			break;
+
+		case EPhase::Spawn:
+		{
+			APlayerController* RemoteController = nullptr;
+			for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It)
+			{
+				if (It->IsValid() && !(*It)->IsLocalController())
+				{
+					RemoteController = It->Get();
+				}
+			}
+			if (!RemoteController)
+			{
+				Test.AddError(TEXT("No PlayerController for the client on the server"));
+				Phase = EPhase::Done;
+				break;
+			}
+
+			// The client's camera looks straight at the Interactable, well within reach
+			auto* Pawn = ServerWorld->SpawnActor<AOGInteractionsTestPawn>(FVector(0.0, 0.0, 150.0), FRotator::ZeroRotator);
+			RemoteController->Possess(Pawn);
+			ServerInteractable = ServerWorld->SpawnActor<AOGInteractionsTestInteractable>(FVector(300.0, 0.0, 150.0), FRotator::ZeroRotator);
+			ServerInteractable->bRejectInteractions = Case == ECase::Reject;
+			SetPhase(EPhase::WaitForClient);
+			break;
+		}
+
+		case EPhase::WaitForClient:
+		{
+			for (TActorIterator<AOGInteractionsTestPawn> It(ClientWorld); It; ++It)
+			{
+				if (It->IsLocallyControlled())
+				{
+					ClientPawn = *It;
+				}
+			}
+			for (TActorIterator<AOGInteractionsTestInteractable> It(ClientWorld); It; ++It)
+			{
+				ClientInteractable = *It;
+			}
+
+			if (ClientPawn.IsValid() && ClientInteractable.IsValid() && ClientInteractable->Interactable->GetHandle().IsValid())
+			{
+				OGInteractionsTests::ExecNetCommand(ServerWorld, PacketLag);
+				OGInteractionsTests::ExecNetCommand(ServerWorld, PacketLoss);
+				OGInteractionsTests::ExecNetCommand(ClientWorld, PacketLag);
+				OGInteractionsTests::ExecNetCommand(ClientWorld, PacketLoss);
+
+				ClientPawn->Interactor->PredictInteraction(ClientInteractable->Interactable, OccamsGamkit::Interactions::Examples::InputActions::Interact_Primary);
+				Test.TestEqual(TEXT("Predicted on the client"), ClientInteractable->NumPredicted, 1);
+				Test.TestTrue(TEXT("Disabled on the client right away"), ClientInteractable->Interactable->GetIsDisabled());
+				SetPhase(EPhase::WaitForResolution);
+			}
+			else
+			{
+				HasTimedOut(Test, 30.0, TEXT("the client's pawn and Interactable"));
+			}
+			break;
+		}
+
+		case EPhase::WaitForResolution:
+			if (!ClientPawn.IsValid() || !ClientInteractable.IsValid() || !ServerInteractable.IsValid())
+			{
+				Test.AddError(TEXT("Lost the test actors"));
+				Phase = EPhase::Done;
+			}
+			else if (ClientPawn->NumConfirmed + ClientPawn->NumRejected > 0)
+			{
+				SetPhase(EPhase::Settle);
+			}
+			else
+			{
+				HasTimedOut(Test, 10.0, TEXT("the prediction to resolve"));
+			}
+			break;
+
+		case EPhase::Settle:
+			// Long enough for anything resent to arrive, then the client has to agree with the server
+			if (!ClientInteractable.IsValid() || !ServerInteractable.IsValid())
+			{
+				Test.AddError(TEXT("Lost the test actors"));
+				Phase = EPhase::Done;
+			}
+			else if (GetPhaseTime() > 2.0 && ClientInteractable->Interactable->GetIsDisabled() == ServerInteractable->Interactable->GetIsDisabled())
+			{
+				CheckOutcome(Test);
+				Phase = EPhase::Done;
+			}
+			else
+			{
+				HasTimedOut(Test, 10.0, TEXT("the client's disabled state to match the server's"));
+			}
+			break;
+
+		case EPhase::Done:
+			break;
+		}
+		return Phase == EPhase::Done;
+	}
+
+	void FPredictionTest::CheckOutcome(FAutomationTestBase& Test) const
+	{
+		const bool bServerAccepts = Case != ECase::Reject;
+		const bool bConfirmed = Case == ECase::Confirm;
+
+		Test.TestEqual(TEXT("Server interactions"), ServerInteractable->NumSucceeded, bServerAccepts ? 1 : 0);
+		Test.TestEqual(TEXT("Disabled on the server"), ServerInteractable->Interactable->GetIsDisabled(), bServerAccepts);
+		Test.TestEqual(TEXT("Confirmed predictions"), ClientPawn->NumConfirmed, bConfirmed ? 1 : 0);
+		Test.TestEqual(TEXT("Rejected predictions"), ClientPawn->NumRejected, bConfirmed ? 0 : 1);
+		Test.TestEqual(TEXT("Rollbacks on the client"), ClientInteractable->NumRolledBack, bConfirmed ? 0 : 1);
+		// A timed out prediction was rolled back to the last server state, which the confirmed change then replicated over
+		Test.TestEqual(TEXT("Disabled on the client"), ClientInteractable->Interactable->GetIsDisabled(), bServerAccepts);
+	}
+}
+
+/*
+ * A client predicts an interaction over a lagged and lossy connection (listen server + client in PIE),
+ * and the server confirms it, rejects it, or answers after the prediction timed out
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FOGInteractionsPredictionTest, "OGInteractions.Network.Prediction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FOGInteractionsPredictionTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Append({ TEXT("Confirm"), TEXT("Reject"), TEXT("Timeout") });
+	OutTestCommands.Append({ TEXT("Confirm"), TEXT("Reject"), TEXT("Timeout") });
+}
+
+bool FOGInteractionsPredictionTest::RunTest(const FString& Parameters)
+{
+	using namespace OGInteractionsPredictionTest;
+
+	const TSharedRef<FPredictionTest> Test = MakeShared<FPredictionTest>();
+	Test->Case = Parameters == TEXT("Reject") ? ECase::Reject : (Parameters == TEXT("Timeout") ? ECase::Timeout : ECase::Confirm);
+
+	// Shorter than one round trip at PktLag=150
+	IConsoleVariable* PredictionTimeout = IConsoleManager::Get().FindConsoleVariable(TEXT("OG.Interactions.PredictionTimeout"));
+	if (!TestNotNull(TEXT("OG.Interactions.PredictionTimeout"), PredictionTimeout))
+		return false;
+	const float PreviousTimeout = PredictionTimeout->GetFloat();
+	if (Test->Case == ECase::Timeout)
+	{
+		PredictionTimeout->Set(0.1f, ECVF_SetByCode);
+	}
+
+	OGInteractionsTests::StartListenServerPIE();
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Test]()
+	{
+		return Test->Update(*this);
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([PredictionTimeout, PreviousTimeout]()
+	{
+		PredictionTimeout->Set(PreviousTimeout, ECVF_SetByCode);
+		OGInteractionsTests::EndPIE();
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		return !OGInteractionsTests::IsPIERunning();
+	}));
+	return true;
+}
+
+#endif
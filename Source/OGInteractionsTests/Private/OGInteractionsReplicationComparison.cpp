@@ -0,0 +1,311 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Dom/JsonObject.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestPIE.h"
+#include "OGInteractionsTestWorld.h"
+
+#if WITH_EDITOR && WITH_DEV_AUTOMATION_TESTS
+
+namespace OGInteractionsReplicationComparison
+{
+	struct FResult
+	{
+		uint64 BytesSent = 0;
+		double ReplicateActorsMs = 0.0;
+		int32 Frames = 0;
+	};
+
+	/*
+	 * Runs the same load once per replication path: spawn the Interactables on the server, wait for the client to have them all,
+	 * flip bDisabled on a few every frame while measuring, check the client ends up agreeing on each one's state, then destroy them
+	 */
+	struct FComparison
+	{
+		enum class EPhase : uint8
+		{
+			WaitForPIE,
+			Spawn,
+			WaitForClient,
+			Measure,
+			WaitForConsistency,
+			Cleanup,
+			Done,
+		};
+
+		int32 NumInteractables = 1000;
+		int32 TogglesPerFrame = 10;
+		int32 NumFrames = 120;
+		TArray<TSubclassOf<AOGInteractionsTestInteractable>> Classes;
+
+		EPhase Phase = EPhase::WaitForPIE;
+		int32 ClassIndex = 0;
+		int32 Frame = 0;
+		double PhaseStartTime = 0.0;
+		uint64 BytesAtStart = 0;
+		TArray<TWeakObjectPtr<AOGInteractionsTestInteractable>> ServerInteractables;
+		TArray<FResult> Results;
+
+		// Returns true once done, errors go to Test
+		bool Update(FAutomationTestBase& Test);
+
+	private:
+		void SetPhase(EPhase InPhase) { Phase = InPhase; PhaseStartTime = FPlatformTime::Seconds(); Frame = 0; }
+		bool HasTimedOut(FAutomationTestBase& Test, double Seconds, const TCHAR* Waiting);
+		static int32 CountInteractables(UWorld* World);
+
+		struct FInteractableState
+		{
+			bool bDisabled = false;
+			uint8 NetState = 0;
+		};
+		static void GatherStates(UWorld* World, TMap<FOGInteractableHandle, FInteractableState>& OutStates);
+		// The first Interactable whose state on the client differs from the server's, matched by handle. Empty once they all agree
+		static FString FindMismatch(UWorld* ServerWorld, UWorld* ClientWorld);
+	};
+
+	bool FComparison::HasTimedOut(FAutomationTestBase& Test, double Seconds, const TCHAR* Waiting)
+	{
+		if (FPlatformTime::Seconds() - PhaseStartTime < Seconds)
+			return false;
+
+		Test.AddError(FString::Printf(TEXT("Timed out waiting for %s"), Waiting));
+		Phase = EPhase::Done;
+		return true;
+	}
+
+	int32 FComparison::CountInteractables(UWorld* World)
+	{
+		int32 Num = 0;
+		for (TActorIterator<AOGInteractionsTestInteractable> It(World); It; ++It)
+		{
+			++Num;
+		}
+		return Num;
+	}
+
+	void FComparison::GatherStates(UWorld* World, TMap<FOGInteractableHandle, FInteractableState>& OutStates)
+	{
+		OutStates.Reset();
+		for (TActorIterator<AOGInteractionsTestInteractable> It(World); It; ++It)
+		{
+			const UOGInteractableComponent_Base* Interactable = It->Interactable;
+			OutStates.Add(Interactable->GetHandle(), { Interactable->GetIsDisabled(), Interactable->GetNetState() });
+		}
+	}
+
+	FString FComparison::FindMismatch(UWorld* ServerWorld, UWorld* ClientWorld)
+	{
+		TMap<FOGInteractableHandle, FInteractableState> ServerStates, ClientStates;
+		GatherStates(ServerWorld, ServerStates);
+		GatherStates(ClientWorld, ClientStates);
+
+		for (const TPair<FOGInteractableHandle, FInteractableState>& ServerState : ServerStates)
+		{
+			// Interactables whose handle hasn't arrived yet all share the invalid one, so they show up as missing
+			const FInteractableState* ClientState = ClientStates.Find(ServerState.Key);
+			if (!ClientState)
+				return FString::Printf(TEXT("%s is missing on the client"), *ServerState.Key.ToString());
+
+			if (ClientState->bDisabled != ServerState.Value.bDisabled || ClientState->NetState != ServerState.Value.NetState)
+			{
+				return FString::Printf(TEXT("%s is disabled %d, NetState %d on the server but disabled %d, NetState %d on the client"),
+					*ServerState.Key.ToString(), ServerState.Value.bDisabled, ServerState.Value.NetState, ClientState->bDisabled, ClientState->NetState);
+			}
+		}
+		if (ClientStates.Num() != ServerStates.Num())
+			return FString::Printf(TEXT("the client has %d Interactables, the server %d"), ClientStates.Num(), ServerStates.Num());
+		return FString();
+	}
+
+	bool FComparison::Update(FAutomationTestBase& Test)
+	{
+		UWorld* ServerWorld = OGInteractionsTests::FindPIEWorld(NM_ListenServer);
+		UWorld* ClientWorld = OGInteractionsTests::FindPIEWorld(NM_Client);
+		if (Phase != EPhase::WaitForPIE && Phase != EPhase::Done && (!ServerWorld || !ClientWorld))
+		{
+			Test.AddError(TEXT("The play session ended early"));
+			Phase = EPhase::Done;
+		}
+
+		switch (Phase)
+		{
+		case EPhase::WaitForPIE:
+			if (OGInteractionsTests::IsListenServerPIEReady())
+			{
+				SetPhase(EPhase::Spawn);
+			}
+			else if (PhaseStartTime == 0.0)
+			{
+				PhaseStartTime = FPlatformTime::Seconds();
+			}
+			else
+			{
+				HasTimedOut(Test, 60.0, TEXT("the listen server and client"));
+			}
+			break;
+
+		case EPhase::Spawn:
+		{
+			const int32 GridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<double>(NumInteractables)));
+			ServerInteractables.Reset();
+			for (int32 Index = 0; Index < NumInteractables; ++Index)
+			{
+				const FVector Location((Index % GridSide) * 200.0, (Index / GridSide) * 200.0, 0.0);
+				ServerInteractables.Add(ServerWorld->SpawnActor<AOGInteractionsTestInteractable>(Classes[ClassIndex], Location, FRotator::ZeroRotator));
+			}
+			SetPhase(EPhase::WaitForClient);
+			break;
+		}
+
+		case EPhase::WaitForClient:
+		{
+			const int32 NumOnClient = CountInteractables(ClientWorld);
+			// A few more frames for anything still in flight, the initial bunches shouldn't be part of the measurement
+			if (NumOnClient == NumInteractables && ++Frame > 30)
+			{
+				SetPhase(EPhase::Measure);
+				BytesAtStart = OGInteractionsTests::GetServerBytesSent();
+				Results.AddDefaulted();
+			}
+			else
+			{
+				HasTimedOut(Test, 60.0, TEXT("the client to receive every Interactable"));
+			}
+			break;
+		}
+
+		case EPhase::Measure:
+		{
+			for (int32 Toggle = 0; Toggle < TogglesPerFrame; ++Toggle)
+			{
+				if (AOGInteractionsTestInteractable* Interactable = ServerInteractables[(Frame * TogglesPerFrame + Toggle) % ServerInteractables.Num()].Get())
+				{
+					Interactable->Interactable->SetDisabled(!Interactable->Interactable->GetIsDisabled());
+				}
+			}
+
+			// Timed here rather than inside the net driver's own tick flush, which then finds this frame already sent
+			UNetDriver* NetDriver = ServerWorld->GetNetDriver();
+			const double StartTime = FPlatformTime::Seconds();
+			NetDriver->ServerReplicateActors(ServerWorld->GetDeltaSeconds());
+			Results.Last().ReplicateActorsMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			if (++Frame >= NumFrames)
+			{
+				Results.Last().Frames = Frame;
+				Results.Last().BytesSent = OGInteractionsTests::GetServerBytesSent() - BytesAtStart;
+				SetPhase(EPhase::WaitForConsistency);
+			}
+			break;
+		}
+
+		case EPhase::WaitForConsistency:
+		{
+			const FString Mismatch = FindMismatch(ServerWorld, ClientWorld);
+			if (Mismatch.IsEmpty())
+			{
+				for (const TWeakObjectPtr<AOGInteractionsTestInteractable>& Interactable : ServerInteractables)
+				{
+					if (Interactable.IsValid())
+					{
+						Interactable->Destroy();
+					}
+				}
+				SetPhase(EPhase::Cleanup);
+			}
+			else
+			{
+				HasTimedOut(Test, 10.0, *FString::Printf(TEXT("the client's states to match the server's, %s"), *Mismatch));
+			}
+			break;
+		}
+
+		case EPhase::Cleanup:
+		{
+			if (CountInteractables(ClientWorld) == 0)
+			{
+				SetPhase(++ClassIndex < Classes.Num() ? EPhase::Spawn : EPhase::Done);
+			}
+			else
+			{
+				HasTimedOut(Test, 30.0, TEXT("the client to destroy the Interactables"));
+			}
+			break;
+		}
+
+		case EPhase::Done:
+			break;
+		}
+		return Phase == EPhase::Done;
+	}
+}
+
+/*
+ * Bytes the server sends and time it spends in ServerReplicateActors for the same churn of bDisabled changes,
+ * with each Interactable replicating itself and with them replicating through the level's AOGInteractableStateManager.
+ * -OGBenchInteractables=N (1000), -OGBenchToggles=T (10 per frame) and -OGBenchFrames=F (120) change the load
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOGInteractionsReplicationComparison, "OGInteractions.Benchmark.Replication",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FOGInteractionsReplicationComparison::RunTest(const FString& Parameters)
+{
+	using namespace OGInteractionsReplicationComparison;
+
+	const TSharedRef<FComparison> Comparison = MakeShared<FComparison>();
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchInteractables="), Comparison->NumInteractables);
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchToggles="), Comparison->TogglesPerFrame);
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchFrames="), Comparison->NumFrames);
+	Comparison->Classes = { AOGInteractionsTestInteractable::StaticClass(), AOGInteractionsTestManagedInteractable::StaticClass() };
+
+	OGInteractionsTests::StartListenServerPIE();
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Comparison]()
+	{
+		return Comparison->Update(*this);
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		OGInteractionsTests::EndPIE();
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Comparison]()
+	{
+		if (OGInteractionsTests::IsPIERunning())
+			return false;
+		if (Comparison->Results.Num() != Comparison->Classes.Num())
+			return true;
+
+		const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+		Report->SetNumberField(TEXT("Interactables"), Comparison->NumInteractables);
+		Report->SetNumberField(TEXT("TogglesPerFrame"), Comparison->TogglesPerFrame);
+		Report->SetNumberField(TEXT("Frames"), Comparison->NumFrames);
+		const TCHAR* ResultNames[] = { TEXT("PerComponent"), TEXT("StateManager") };
+		for (int32 Index = 0; Index < Comparison->Results.Num(); ++Index)
+		{
+			const FResult& Result = Comparison->Results[Index];
+			const double Frames = FMath::Max(Result.Frames, 1);
+			const TSharedRef<FJsonObject> ResultReport = MakeShared<FJsonObject>();
+			ResultReport->SetNumberField(TEXT("BytesSent"), static_cast<double>(Result.BytesSent));
+			ResultReport->SetNumberField(TEXT("BytesPerFrame"), Result.BytesSent / Frames);
+			ResultReport->SetNumberField(TEXT("ReplicateActorsMsPerFrame"), Result.ReplicateActorsMs / Frames);
+			Report->SetObjectField(ResultNames[Index], ResultReport);
+			AddInfo(FString::Printf(TEXT("%s: %.0f B and %.3f ms ServerReplicateActors per frame"), ResultNames[Index], Result.BytesSent / Frames, Result.ReplicateActorsMs / Frames));
+		}
+		const FString ReportPath = OGInteractionsTests::WriteReport(TEXT("Replication"), Report);
+		TestFalse(TEXT("Report written"), ReportPath.IsEmpty());
+
+		// The same changes go out either way, the state manager only sends the changed items of one array
+		TestTrue(TEXT("The state manager sends less than per-component replication"), Comparison->Results[1].BytesSent < Comparison->Results[0].BytesSent);
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,136 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Misc/AutomationTest.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestWorld.h"
+#include "Utilities/OGInteractionTags.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace OGInteractionsRequestLimitTest
+{
+	// Overrides a console variable until it goes out of scope
+	struct FScopedConsoleVariable
+	{
+		FScopedConsoleVariable(const TCHAR* Name, float Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Variable)
+			{
+				PreviousValue = Variable->GetFloat();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedConsoleVariable()
+		{
+			if (Variable)
+			{
+				Variable->Set(PreviousValue, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* Variable = nullptr;
+		float PreviousValue = 0.f;
+	};
+}
+
+/*
+ * The server side limits on interaction requests, in a standalone world where the interactor's own requests are processed
+ * and answered within the frame that sends them:
+ *	- BurstCap: a batch past OG.Interactions.RequestBurst gets the tail rejected straight away, rather than left to time out
+ *	- Refill: once the bucket is empty requests are rejected until OG.Interactions.RequestRate refills it
+ *	- OutOfReach: a request for an Interactable past the interactor's reach is rejected before its CanInteract
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FOGInteractionsRequestLimitTest, "OGInteractions.RequestLimits",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+void FOGInteractionsRequestLimitTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Append({ TEXT("BurstCap"), TEXT("Refill"), TEXT("OutOfReach") });
+	OutTestCommands.Append({ TEXT("BurstCap"), TEXT("Refill"), TEXT("OutOfReach") });
+}
+
+bool FOGInteractionsRequestLimitTest::RunTest(const FString& Parameters)
+{
+	using namespace OGInteractionsRequestLimitTest;
+
+	// One request a second, three at once, and no slack past the interactor's reach
+	const FScopedConsoleVariable RequestRate(TEXT("OG.Interactions.RequestRate"), 1.f);
+	const FScopedConsoleVariable RequestBurst(TEXT("OG.Interactions.RequestBurst"), 3.f);
+	const FScopedConsoleVariable DistanceTolerance(TEXT("OG.Interactions.RequestDistanceTolerance"), 0.f);
+	if (!TestNotNull(TEXT("OG.Interactions.RequestRate"), RequestRate.Variable)
+		|| !TestNotNull(TEXT("OG.Interactions.RequestBurst"), RequestBurst.Variable)
+		|| !TestNotNull(TEXT("OG.Interactions.RequestDistanceTolerance"), DistanceTolerance.Variable))
+	{
+		return false;
+	}
+
+	FOGInteractionsTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	AOGInteractionsTestPawn* Pawn = TestWorld.SpawnInteractor(FVector::ZeroVector, FRotator::ZeroRotator);
+	UOGInteractorComponent* Interactor = Pawn->Interactor;
+
+	// One Interactable per request, since a confirmed one disables itself
+	TArray<AOGInteractionsTestInteractable*> InReach;
+	for (int32 Index = 0; Index < 6; ++Index)
+	{
+		InReach.Add(World->SpawnActor<AOGInteractionsTestInteractable>(FVector(200.0, 0.0, 0.0), FRotator::ZeroRotator));
+	}
+	auto* OutOfReach = World->SpawnActor<AOGInteractionsTestInteractable>(FVector(Interactor->RaycastRange * 4.0, 0.0, 0.0), FRotator::ZeroRotator);
+	TestWorld.Tick();
+
+	// Predicts an interaction with each of Interactables in one batch, and ticks once to send, process and answer it
+	auto RequestBatch = [&](TArrayView<AOGInteractionsTestInteractable* const> Interactables)
+	{
+		Pawn->NumConfirmed = 0;
+		Pawn->NumRejected = 0;
+		for (AOGInteractionsTestInteractable* Interactable : Interactables)
+		{
+			Interactor->PredictInteraction(Interactable->Interactable, OccamsGamkit::Interactions::Examples::InputActions::Interact_Primary);
+		}
+		TestWorld.Tick();
+	};
+
+	if (Parameters == TEXT("BurstCap"))
+	{
+		RequestBatch(MakeArrayView(InReach).Left(5));
+		TestEqual(TEXT("Requests within the burst are confirmed"), Pawn->NumConfirmed, 3);
+		TestEqual(TEXT("Requests past the burst are rejected in the same answer"), Pawn->NumRejected, 2);
+		TestEqual(TEXT("Requests past the burst never reach their Interactable"), InReach[3]->NumSucceeded + InReach[4]->NumSucceeded, 0);
+	}
+	else if (Parameters == TEXT("Refill"))
+	{
+		RequestBatch(MakeArrayView(InReach).Left(3));
+		TestEqual(TEXT("A full bucket's worth is confirmed"), Pawn->NumConfirmed, 3);
+
+		RequestBatch(MakeArrayView(InReach).Slice(3, 1));
+		TestEqual(TEXT("An empty bucket rejects"), Pawn->NumRejected, 1);
+
+		// 1.5 seconds at one request a second refills one token, not two
+		TestWorld.Tick(90);
+		RequestBatch(MakeArrayView(InReach).Slice(4, 2));
+		TestEqual(TEXT("The refilled token is used"), Pawn->NumConfirmed, 1);
+		TestEqual(TEXT("Nothing past the refilled token is accepted"), Pawn->NumRejected, 1);
+	}
+	else if (Parameters == TEXT("OutOfReach"))
+	{
+		AOGInteractionsTestInteractable* Batch[] = { InReach[0], OutOfReach };
+		RequestBatch(Batch);
+		TestEqual(TEXT("The Interactable in reach is confirmed"), Pawn->NumConfirmed, 1);
+		TestEqual(TEXT("The Interactable out of reach is rejected"), Pawn->NumRejected, 1);
+		TestEqual(TEXT("The Interactable out of reach never gets the request"), OutOfReach->NumSucceeded, 0);
+	}
+	else
+	{
+		AddError(FString::Printf(TEXT("Unknown case '%s'"), *Parameters));
+		return false;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,156 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "OGInteractionsTestActors.h"
+#include "OGInteractionsTestAllocations.h"
+#include "OGInteractionsTestWorld.h"
+#include "Subsystems/OGInteractableRegistrySubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+ * Spawns N Interactables in each of Initialize's configurations, drives M interactors along scripted camera paths over them,
+ * and writes per-frame tick/resolve time, traces, state transitions and allocations, with memory per Interactable, as JSON.
+ * -OGBenchInteractors=M (16) and -OGBenchFrames=F (300) on the command line change the load
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FOGInteractionsScalingBenchmark, "OGInteractions.Benchmark.Scaling",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FOGInteractionsScalingBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const EOGTestInteractableConfig Config : { EOGTestInteractableConfig::QueryVolume, EOGTestInteractableConfig::PhysicalRepresentation, EOGTestInteractableConfig::Mixed })
+	{
+		for (const int32 NumInteractables : { 1000, 10000 })
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%s.%d"), OGInteractionsTests::LexToString(Config), NumInteractables));
+			OutTestCommands.Add(FString::Printf(TEXT("%s %d"), OGInteractionsTests::LexToString(Config), NumInteractables));
+		}
+	}
+}
+
+bool FOGInteractionsScalingBenchmark::RunTest(const FString& Parameters)
+{
+	FString ConfigName, CountString;
+	EOGTestInteractableConfig Config;
+	if (!Parameters.Split(TEXT(" "), &ConfigName, &CountString) || !OGInteractionsTests::ParseConfig(ConfigName, Config))
+	{
+		AddError(FString::Printf(TEXT("Bad parameters '%s'"), *Parameters));
+		return false;
+	}
+	const int32 NumInteractables = FCString::Atoi(*CountString);
+	int32 NumInteractors = 16;
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchInteractors="), NumInteractors);
+	int32 NumFrames = 300;
+	FParse::Value(FCommandLine::Get(), TEXT("OGBenchFrames="), NumFrames);
+
+	FOGInteractionsTestWorld TestWorld;
+	auto* Registry = UOGInteractableRegistrySubsystem::Get(TestWorld.GetWorld());
+	if (!TestNotNull(TEXT("Registry"), Registry))
+		return false;
+
+	// A square grid, 3m apart
+	constexpr double Spacing = 300.0;
+	const int32 GridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<double>(NumInteractables)));
+	const FVector GridCenter(GridSide * Spacing * 0.5, GridSide * Spacing * 0.5, 0.0);
+
+	uint64 SpawnAllocations = 0, SpawnBytes = 0;
+	{
+		FOGScopedAllocationCounter Allocations;
+		for (int32 Index = 0; Index < NumInteractables; ++Index)
+		{
+			TestWorld.SpawnInteractable(FVector((Index % GridSide) * Spacing, (Index / GridSide) * Spacing, 0.0), Config);
+		}
+		SpawnAllocations = Allocations.GetNumAllocations();
+		SpawnBytes = Allocations.GetAllocatedBytes();
+	}
+
+	// Each interactor circles the grid centre at its own radius and phase, sweeping its view side to side while looking down
+	TArray<AOGInteractionsTestPawn*> Interactors;
+	const double MaxRadius = GridSide * Spacing * 0.45;
+	auto GetPathTransform = [&](int32 Interactor, int32 Frame, FVector& OutLocation, FRotator& OutRotation)
+	{
+		const double Radius = MaxRadius * (0.25 + 0.75 * (Interactor + 1) / NumInteractors);
+		const double Angle = UE_TWO_PI * (Frame / 600.0 + static_cast<double>(Interactor) / NumInteractors);
+		OutLocation = GridCenter + FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), 150.0);
+		OutRotation = FRotator(-25.0, FMath::RadiansToDegrees(Angle) + 90.0 + 40.0 * FMath::Sin(Angle * 7.0), 0.0);
+	};
+	for (int32 Index = 0; Index < NumInteractors; ++Index)
+	{
+		FVector Location;
+		FRotator Rotation;
+		GetPathTransform(Index, 0, Location, Rotation);
+		Interactors.Add(TestWorld.SpawnInteractor(Location, Rotation));
+	}
+
+	// Settle registration and the first candidates before measuring
+	TestWorld.Tick(30);
+	Registry->StartStatsCapture(NumFrames);
+
+	TArray<TSharedPtr<FJsonValue>> Frames;
+	Frames.Reserve(NumFrames);
+	double TotalTickMs = 0.0, MaxTickMs = 0.0, TotalResolveMs = 0.0;
+	int64 TotalTraces = 0, TotalTransitions = 0, TotalFrameAllocations = 0;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 Index = 0; Index < Interactors.Num(); ++Index)
+		{
+			FVector Location;
+			FRotator Rotation;
+			GetPathTransform(Index, Frame, Location, Rotation);
+			Interactors[Index]->SetActorLocationAndRotation(Location, Rotation);
+		}
+
+		uint64 FrameAllocations = 0;
+		{
+			FOGScopedAllocationCounter Allocations;
+			TestWorld.Tick();
+			FrameAllocations = Allocations.GetNumAllocations();
+		}
+
+		const FOGInteractionsWorldStats& Stats = Registry->GetWorldStats();
+		TotalTickMs += Stats.InteractorTickMsLastFrame;
+		MaxTickMs = FMath::Max<double>(MaxTickMs, Stats.InteractorTickMsLastFrame);
+		TotalResolveMs += Stats.ResolveMsLastFrame;
+		TotalTraces += Stats.TracesLastFrame;
+		TotalTransitions += Stats.StateTransitionsLastFrame;
+		TotalFrameAllocations += FrameAllocations;
+
+		const TSharedRef<FJsonObject> FrameReport = MakeShared<FJsonObject>();
+		FrameReport->SetNumberField(TEXT("InteractorTickMs"), Stats.InteractorTickMsLastFrame);
+		FrameReport->SetNumberField(TEXT("ResolveMs"), Stats.ResolveMsLastFrame);
+		FrameReport->SetNumberField(TEXT("Traces"), Stats.TracesLastFrame);
+		FrameReport->SetNumberField(TEXT("StateTransitions"), Stats.StateTransitionsLastFrame);
+		FrameReport->SetNumberField(TEXT("Allocations"), static_cast<double>(FrameAllocations));
+		Frames.Add(MakeShared<FJsonValueObject>(FrameReport));
+	}
+
+	const double FrameCount = FMath::Max(NumFrames, 1);
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Config"), OGInteractionsTests::LexToString(Config));
+	Report->SetNumberField(TEXT("Interactables"), NumInteractables);
+	Report->SetNumberField(TEXT("Interactors"), NumInteractors);
+	Report->SetNumberField(TEXT("Frames"), NumFrames);
+	Report->SetNumberField(TEXT("BytesPerInteractable"), static_cast<double>(SpawnBytes) / FMath::Max(NumInteractables, 1));
+	Report->SetNumberField(TEXT("AllocationsPerInteractable"), static_cast<double>(SpawnAllocations) / FMath::Max(NumInteractables, 1));
+	Report->SetNumberField(TEXT("AvgInteractorTickMs"), TotalTickMs / FrameCount);
+	Report->SetNumberField(TEXT("MaxInteractorTickMs"), MaxTickMs);
+	Report->SetNumberField(TEXT("AvgResolveMs"), TotalResolveMs / FrameCount);
+	Report->SetNumberField(TEXT("AvgTraces"), TotalTraces / FrameCount);
+	Report->SetNumberField(TEXT("AvgStateTransitions"), TotalTransitions / FrameCount);
+	Report->SetNumberField(TEXT("AvgAllocationsPerFrame"), TotalFrameAllocations / FrameCount);
+	Report->SetArrayField(TEXT("PerFrame"), Frames);
+
+	const FString ReportPath = OGInteractionsTests::WriteReport(FString::Printf(TEXT("Scaling_%s_%d"), OGInteractionsTests::LexToString(Config), NumInteractables), Report);
+	AddInfo(FString::Printf(TEXT("%s x%d, %d interactors: tick %.3f ms (max %.3f), resolve %.3f ms, %.0f B per Interactable. %s"),
+		OGInteractionsTests::LexToString(Config), NumInteractables, NumInteractors, TotalTickMs / FrameCount, MaxTickMs,
+		TotalResolveMs / FrameCount, static_cast<double>(SpawnBytes) / FMath::Max(NumInteractables, 1), *ReportPath));
+
+	TestTrue(TEXT("Interactors traced every frame"), TotalTraces >= static_cast<int64>(NumInteractors) * NumFrames);
+	TestTrue(TEXT("Hover state changed along the paths"), TotalTransitions > 0);
+	TestFalse(TEXT("Report written"), ReportPath.IsEmpty());
+	return true;
+}
+
+#endif
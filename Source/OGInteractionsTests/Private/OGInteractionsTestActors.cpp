@@ -0,0 +1,101 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OGInteractionsTestActors.h"
+
+#include "Camera/CameraComponent.h"
+#include "Components/BoxComponent.h"
+#include "Interactable/OGInteractableComponent_BehaviorSet.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Interactor/OGInteractorComponent.h"
+#include "Utilities/OGInteractionTags.h"
+
+
+AOGInteractionsTestPawn::AOGInteractionsTestPawn()
+{
+	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
+	SetRootComponent(Camera);
+	Interactor = CreateDefaultSubobject<UOGInteractorComponent>(TEXT("Interactor"));
+}
+
+void AOGInteractionsTestPawn::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Interactor->OnPredictedInteractionResolved.AddDynamic(this, &AOGInteractionsTestPawn::HandlePredictedInteractionResolved);
+}
+
+void AOGInteractionsTestPawn::HandlePredictedInteractionResolved(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction, bool bConfirmed)
+{
+	if (bConfirmed)
+	{
+		++NumConfirmed;
+	}
+	else
+	{
+		++NumRejected;
+	}
+}
+
+AOGInteractionsTestInteractable::AOGInteractionsTestInteractable()
+{
+	bReplicates = true;
+	// Wherever the client's view ends up, so only the replication path differs between the two classes
+	bAlwaysRelevant = true;
+
+	QueryVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("QueryVolume"));
+	QueryVolume->InitBoxExtent(FVector(50.f));
+	SetRootComponent(QueryVolume);
+
+	Interactable = CreateDefaultSubobject<UOGInteractableComponent_DevelopmentInputPassthrough>(TEXT("Interactable"));
+	Interactable->SetupAttachment(QueryVolume);
+}
+
+void AOGInteractionsTestInteractable::BeginPlay()
+{
+	Super::BeginPlay();
+
+	namespace UIState = OccamsGamkit::Interactions::Examples::UIState;
+	Interactable->SetOnHoverNativeDelegate(FGetUIStateNativeDelegate::CreateLambda([](const AActor*) -> FGameplayTag { return UIState::Hover; }));
+	Interactable->SetOnFocusNativeDelegate(FGetUIStateNativeDelegate::CreateLambda([](const AActor*) -> FGameplayTag { return UIState::Callout; }));
+	Interactable->SetGetDefaultStateNativeDelegate(FGetUIStateNativeDelegate::CreateWeakLambda(this, [this](const AActor*) -> FGameplayTag
+	{
+		return Interactable->GetIsDisabled() ? UIState::Invalid : UIState::None;
+	}));
+	Interactable->SetOnUIStateChangedNativeDelegate(FOnUIStateChangedNativeDelegate::CreateLambda([](const FGameplayTag&) {}));
+	Interactable->Init(TEXT("Interactable"), QueryVolume, nullptr, FOGInteractableComponent_VisualDelegates());
+
+	FOGInteractableComponent_BehaviorSet_Triggered Behavior;
+	Behavior.CanInteractDelegate.BindDynamic(this, &AOGInteractionsTestInteractable::CanInteract);
+	Behavior.OnInteract_SucceededDelegate.BindDynamic(this, &AOGInteractionsTestInteractable::HandleInteractSucceeded);
+	Behavior.OnInteract_PredictedDelegate.BindDynamic(this, &AOGInteractionsTestInteractable::HandleInteractPredicted);
+	Behavior.OnInteract_RolledBackDelegate.BindDynamic(this, &AOGInteractionsTestInteractable::HandleInteractRolledBack);
+	Interactable->BindTriggeredAction(OccamsGamkit::Interactions::Examples::InputActions::Interact_Primary, Behavior);
+}
+
+bool AOGInteractionsTestInteractable::CanInteract(const AActor* Interactor)
+{
+	// The client can't see bRejectInteractions, so it always predicts success
+	return !HasAuthority() || !bRejectInteractions;
+}
+
+void AOGInteractionsTestInteractable::HandleInteractSucceeded(AActor* Interactor)
+{
+	++NumSucceeded;
+	Interactable->SetDisabled(true);
+}
+
+void AOGInteractionsTestInteractable::HandleInteractPredicted(AActor* Interactor)
+{
+	++NumPredicted;
+	Interactable->PredictDisabled(true);
+}
+
+void AOGInteractionsTestInteractable::HandleInteractRolledBack(AActor* Interactor)
+{
+	++NumRolledBack;
+}
+
+AOGInteractionsTestManagedInteractable::AOGInteractionsTestManagedInteractable()
+{
+	Interactable->bReplicateStateThroughManager = true;
+}
@@ -0,0 +1,102 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameplayTagContainer.h"
+#include "Interactor/OGInteractorInterface.h"
+#include "OGInteractionsTestActors.generated.h"
+
+class UBoxComponent;
+class UCameraComponent;
+class UOGInteractableComponent_Base;
+class UOGInteractableComponent_DevelopmentInputPassthrough;
+class UOGInteractorComponent;
+
+// A pawn whose interactor raycasts from its camera, moved around by the tests
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AOGInteractionsTestPawn : public APawn, public IOGInteractorInterface
+{
+	GENERATED_BODY()
+
+public:
+	AOGInteractionsTestPawn();
+
+	virtual void BeginPlay() override;
+	virtual UOGInteractorComponent* GetInteractorComponent_Implementation() const override { return Interactor; }
+
+	UPROPERTY()
+	TObjectPtr<UCameraComponent> Camera;
+	UPROPERTY()
+	TObjectPtr<UOGInteractorComponent> Interactor;
+
+	// Predicted interactions resolved so far
+	int32 NumConfirmed = 0;
+	int32 NumRejected = 0;
+
+protected:
+	UFUNCTION()
+	void HandlePredictedInteractionResolved(UOGInteractableComponent_Base* Interactable, FGameplayTag InputAction, bool bConfirmed);
+};
+
+/*
+ * A replicated Interactable for the network tests. The component is created in the constructor so it is stably named,
+ * and has a Primary behavior that succeeds and disables it unless bRejectInteractions is set on the server
+ */
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AOGInteractionsTestInteractable : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AOGInteractionsTestInteractable();
+
+	virtual void BeginPlay() override;
+
+	UPROPERTY()
+	TObjectPtr<UBoxComponent> QueryVolume;
+	UPROPERTY()
+	TObjectPtr<UOGInteractableComponent_DevelopmentInputPassthrough> Interactable;
+
+	bool bRejectInteractions = false;
+	int32 NumSucceeded = 0;
+	int32 NumPredicted = 0;
+	int32 NumRolledBack = 0;
+
+protected:
+	UFUNCTION()
+	bool CanInteract(const AActor* Interactor);
+	UFUNCTION()
+	void HandleInteractSucceeded(AActor* Interactor);
+	UFUNCTION()
+	void HandleInteractPredicted(AActor* Interactor);
+	UFUNCTION()
+	void HandleInteractRolledBack(AActor* Interactor);
+};
+
+// Same as AOGInteractionsTestInteractable, replicated through the level's state manager instead of its own component
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AOGInteractionsTestManagedInteractable : public AOGInteractionsTestInteractable
+{
+	GENERATED_BODY()
+
+public:
+	AOGInteractionsTestManagedInteractable();
+};
+
+// The Interactable's previous and current parent class with nothing added, compared by OGInteractions.Benchmark.ComponentBase
+UCLASS(NotBlueprintable, Transient)
+class UOGInteractionsTestPrimitiveBase : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+};
+
+UCLASS(NotBlueprintable, Transient)
+class UOGInteractionsTestSceneBase : public USceneComponent
+{
+	GENERATED_BODY()
+};
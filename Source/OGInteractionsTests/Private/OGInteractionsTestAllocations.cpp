@@ -0,0 +1,96 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OGInteractionsTestAllocations.h"
+
+namespace OGInteractionsTests
+{
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { Record(Count); return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { Record(Count); return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { Record(Count); return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { Record(Count); return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		// Only touched on the game thread
+		bool bCounting = false;
+		uint64 NumAllocations = 0;
+		uint64 AllocatedBytes = 0;
+
+	private:
+		void Record(SIZE_T Count)
+		{
+			if (bCounting && Count > 0 && IsInGameThread())
+			{
+				++NumAllocations;
+				AllocatedBytes += Count;
+			}
+		}
+
+		FMalloc* Inner;
+	};
+
+	// Never removed, another thread may still be inside it. Anything it allocated is freed by the same inner allocator either way
+	FCountingMalloc& GetCountingMalloc()
+	{
+		static FCountingMalloc* CountingMalloc = nullptr;
+		if (!CountingMalloc)
+		{
+			// Allocated from the inner allocator directly, so it doesn't count itself
+			void* Memory = GMalloc->Malloc(sizeof(FCountingMalloc), alignof(FCountingMalloc));
+			CountingMalloc = new (Memory) FCountingMalloc(GMalloc);
+			GMalloc = CountingMalloc;
+		}
+		return *CountingMalloc;
+	}
+}
+
+FOGScopedAllocationCounter::FOGScopedAllocationCounter()
+{
+	check(IsInGameThread());
+	Reset();
+	OGInteractionsTests::GetCountingMalloc().bCounting = true;
+}
+
+FOGScopedAllocationCounter::~FOGScopedAllocationCounter()
+{
+	OGInteractionsTests::GetCountingMalloc().bCounting = false;
+}
+
+uint64 FOGScopedAllocationCounter::GetNumAllocations() const
+{
+	return OGInteractionsTests::GetCountingMalloc().NumAllocations;
+}
+
+uint64 FOGScopedAllocationCounter::GetAllocatedBytes() const
+{
+	return OGInteractionsTests::GetCountingMalloc().AllocatedBytes;
+}
+
+void FOGScopedAllocationCounter::Reset()
+{
+	OGInteractionsTests::FCountingMalloc& CountingMalloc = OGInteractionsTests::GetCountingMalloc();
+	CountingMalloc.NumAllocations = 0;
+	CountingMalloc.AllocatedBytes = 0;
+}
+
+void FOGScopedAllocationCounter::SetPaused(bool bInPaused)
+{
+	OGInteractionsTests::GetCountingMalloc().bCounting = !bInPaused;
+}
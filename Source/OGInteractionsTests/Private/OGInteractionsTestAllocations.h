@@ -0,0 +1,25 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Counts the game thread's heap allocations while in scope.
+ * A forwarding FMalloc is put in front of GMalloc on first use and left there, it only counts while a counter is active.
+ * Allocations made by other threads pass through uncounted
+ */
+class FOGScopedAllocationCounter
+{
+public:
+	FOGScopedAllocationCounter();
+	~FOGScopedAllocationCounter();
+
+	// Malloc and Realloc calls, and the bytes they asked for, since construction or the last Reset
+	uint64 GetNumAllocations() const;
+	uint64 GetAllocatedBytes() const;
+	void Reset();
+
+	// Stop counting around the test's own bookkeeping
+	void SetPaused(bool bInPaused);
+};
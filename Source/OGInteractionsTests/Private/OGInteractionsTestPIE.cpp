@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OGInteractionsTestPIE.h"
+
+#if WITH_EDITOR
+
+#include "Editor.h"
+#include "Engine/NetDriver.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationEditorCommon.h"
+
+
+namespace OGInteractionsTests
+{
+	void StartListenServerPIE()
+	{
+		FAutomationEditorCommonUtils::CreateNewMap();
+
+		ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+		PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+		// The listen server's own player is the first
+		PlaySettings->SetPlayNumberOfClients(2);
+		PlaySettings->SetRunUnderOneProcess(true);
+
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.EditorPlaySettings = PlaySettings;
+		GEditor->RequestPlaySession(Params);
+	}
+
+	void EndPIE()
+	{
+		GEditor->RequestEndPlayMap();
+	}
+
+	bool IsPIERunning()
+	{
+		return GEditor->PlayWorld != nullptr || GEditor->IsPlaySessionRequestQueued();
+	}
+
+	UWorld* FindPIEWorld(ENetMode NetMode)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NetMode)
+				return World;
+		}
+		return nullptr;
+	}
+
+	bool IsListenServerPIEReady()
+	{
+		const UWorld* ServerWorld = FindPIEWorld(NM_ListenServer);
+		const UWorld* ClientWorld = FindPIEWorld(NM_Client);
+		return ServerWorld && ClientWorld
+			&& ServerWorld->GetNetDriver() && ServerWorld->GetNetDriver()->ClientConnections.Num() > 0
+			&& ClientWorld->GetFirstPlayerController() != nullptr;
+	}
+
+	void ExecNetCommand(UWorld* World, const TCHAR* Command)
+	{
+		GEngine->Exec(World, Command);
+	}
+
+	uint64 GetServerBytesSent()
+	{
+		const UWorld* ServerWorld = FindPIEWorld(NM_ListenServer);
+		const UNetDriver* NetDriver = ServerWorld ? ServerWorld->GetNetDriver() : nullptr;
+		return NetDriver ? static_cast<uint64>(NetDriver->OutTotalBytes) : 0;
+	}
+}
+
+#endif
@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+#if WITH_EDITOR
+
+class UWorld;
+
+/*
+ * Listen server + one client play in editor sessions for the network tests, in one process so both worlds can be inspected.
+ * Start one, then wait on IsListenServerPIEReady from a latent command
+ */
+namespace OGInteractionsTests
+{
+	// Opens a new blank map and requests the session, it starts on the next editor tick
+	void StartListenServerPIE();
+	void EndPIE();
+	bool IsPIERunning();
+
+	// The PIE world running as NetMode, null if there isn't one (yet)
+	UWorld* FindPIEWorld(ENetMode NetMode);
+	// Both worlds are up, and the client is connected with its PlayerController
+	bool IsListenServerPIEReady();
+
+	// Net driver console commands on World's side of the connection only, e.g. "Net PktLag=150"
+	void ExecNetCommand(UWorld* World, const TCHAR* Command);
+	// The server's outgoing bytes across every connection so far
+	uint64 GetServerBytesSent();
+}
+
+#endif
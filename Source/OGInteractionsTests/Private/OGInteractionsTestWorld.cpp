@@ -0,0 +1,142 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OGInteractionsTestWorld.h"
+
+#include "Components/BoxComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Interactable/OGInteractableComponent_DevelopmentInputPassthrough.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OGInteractionsTestActors.h"
+#include "Serialization/JsonSerializer.h"
+#include "Utilities/OGInteractionTags.h"
+
+
+FOGInteractionsTestWorld::FOGInteractionsTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, MakeUniqueObjectName(GetTransientPackage(), UWorld::StaticClass(), TEXT("OGInteractionsTestWorld")));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	// No game mode, so begin play is dispatched directly
+	World->GetWorldSettings()->NotifyBeginPlay();
+	World->BeginPlay();
+
+	CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+}
+
+FOGInteractionsTestWorld::~FOGInteractionsTestWorld()
+{
+	World->BeginTearingDown();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FOGInteractionsTestWorld::Tick(int32 NumFrames, float DeltaSeconds)
+{
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+		++GFrameCounter;
+	}
+}
+
+UOGInteractableComponent_DevelopmentInputPassthrough* FOGInteractionsTestWorld::SpawnInteractable(const FVector& Location, EOGTestInteractableConfig Config)
+{
+	AActor* Actor = World->SpawnActor<AActor>();
+
+	UBoxComponent* QueryVolume = nullptr;
+	if (Config != EOGTestInteractableConfig::PhysicalRepresentation)
+	{
+		QueryVolume = NewObject<UBoxComponent>(Actor, TEXT("QueryVolume"));
+		QueryVolume->InitBoxExtent(FVector(50.f));
+		Actor->SetRootComponent(QueryVolume);
+		QueryVolume->SetWorldLocation(Location);
+		QueryVolume->RegisterComponent();
+	}
+
+	UStaticMeshComponent* Mesh = nullptr;
+	if (Config != EOGTestInteractableConfig::QueryVolume)
+	{
+		Mesh = NewObject<UStaticMeshComponent>(Actor, TEXT("Mesh"));
+		Mesh->SetStaticMesh(CubeMesh);
+		if (QueryVolume)
+		{
+			Mesh->SetupAttachment(QueryVolume);
+		}
+		else
+		{
+			Actor->SetRootComponent(Mesh);
+		}
+		Mesh->SetWorldLocation(Location);
+		Mesh->RegisterComponent();
+	}
+
+	auto* Interactable = NewObject<UOGInteractableComponent_DevelopmentInputPassthrough>(Actor, TEXT("Interactable"));
+	Interactable->SetupAttachment(Actor->GetRootComponent());
+
+	namespace UIState = OccamsGamkit::Interactions::Examples::UIState;
+	Interactable->SetOnHoverNativeDelegate(FGetUIStateNativeDelegate::CreateLambda([](const AActor*) -> FGameplayTag { return UIState::Hover; }));
+	Interactable->SetOnFocusNativeDelegate(FGetUIStateNativeDelegate::CreateLambda([](const AActor*) -> FGameplayTag { return UIState::Callout; }));
+	Interactable->SetGetDefaultStateNativeDelegate(FGetUIStateNativeDelegate::CreateLambda([](const AActor*) -> FGameplayTag { return UIState::None; }));
+	Interactable->SetOnUIStateChangedNativeDelegate(FOnUIStateChangedNativeDelegate::CreateLambda([](const FGameplayTag&) {}));
+
+	Interactable->RegisterComponent();
+	Interactable->Init(TEXT("Interactable"), QueryVolume, Mesh, FOGInteractableComponent_VisualDelegates());
+	return Interactable;
+}
+
+AOGInteractionsTestPawn* FOGInteractionsTestWorld::SpawnInteractor(const FVector& Location, const FRotator& Rotation)
+{
+	auto* Pawn = World->SpawnActor<AOGInteractionsTestPawn>(Location, Rotation);
+	// Standalone player controllers are always local, which is all the interactor checks before tracing and conveying
+	auto* Controller = World->SpawnActor<APlayerController>();
+	Controller->Possess(Pawn);
+	return Pawn;
+}
+
+namespace OGInteractionsTests
+{
+	bool ParseConfig(const FString& Name, EOGTestInteractableConfig& OutConfig)
+	{
+		for (const EOGTestInteractableConfig Config : { EOGTestInteractableConfig::QueryVolume, EOGTestInteractableConfig::PhysicalRepresentation, EOGTestInteractableConfig::Mixed })
+		{
+			if (Name == LexToString(Config))
+			{
+				OutConfig = Config;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const TCHAR* LexToString(EOGTestInteractableConfig Config)
+	{
+		switch (Config)
+		{
+		case EOGTestInteractableConfig::QueryVolume: return TEXT("QueryVolume");
+		case EOGTestInteractableConfig::PhysicalRepresentation: return TEXT("PhysicalRepresentation");
+		case EOGTestInteractableConfig::Mixed: return TEXT("Mixed");
+		}
+		return TEXT("Unknown");
+	}
+
+	FString WriteReport(const FString& Name, const TSharedRef<FJsonObject>& Report)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		if (!FJsonSerializer::Serialize(Report, Writer))
+			return FString();
+
+		const FString FilePath = FPaths::ProfilingDir() / TEXT("OGInteractions") / TEXT("Benchmarks") / (Name + TEXT(".json"));
+		return FFileHelper::SaveStringToFile(Json, *FilePath) ? FilePath : FString();
+	}
+}
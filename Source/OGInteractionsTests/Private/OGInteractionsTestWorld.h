@@ -0,0 +1,50 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AOGInteractionsTestPawn;
+class FJsonObject;
+class UOGInteractableComponent_DevelopmentInputPassthrough;
+class UStaticMesh;
+
+// Which of Initialize's query setups a spawned Interactable uses
+enum class EOGTestInteractableConfig : uint8
+{
+	QueryVolume,
+	PhysicalRepresentation,
+	// Both, queried through the volume
+	Mixed,
+};
+
+/*
+ * A standalone game world created for one test and ticked by hand. Nothing in it renders, so it runs under -NullRHI
+ */
+class FOGInteractionsTestWorld
+{
+public:
+	FOGInteractionsTestWorld();
+	~FOGInteractionsTestWorld();
+
+	UWorld* GetWorld() const { return World; }
+	void Tick(int32 NumFrames = 1, float DeltaSeconds = 1.f / 60.f);
+
+	// A 100cm cube Interactable with native UI state handlers, already initialized
+	UOGInteractableComponent_DevelopmentInputPassthrough* SpawnInteractable(const FVector& Location, EOGTestInteractableConfig Config);
+	// A player controlled pawn, its interactor traces from its camera every tick
+	AOGInteractionsTestPawn* SpawnInteractor(const FVector& Location, const FRotator& Rotation);
+
+private:
+	UWorld* World = nullptr;
+	UStaticMesh* CubeMesh = nullptr;
+};
+
+namespace OGInteractionsTests
+{
+	bool ParseConfig(const FString& Name, EOGTestInteractableConfig& OutConfig);
+	const TCHAR* LexToString(EOGTestInteractableConfig Config);
+
+	// Writes Report to Saved/Profiling/OGInteractions/Benchmarks/<Name>.json, returning the path (empty on failure)
+	FString WriteReport(const FString& Name, const TSharedRef<FJsonObject>& Report);
+}
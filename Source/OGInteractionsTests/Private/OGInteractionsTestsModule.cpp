@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// Automation tests and benchmarks only, run with `-ExecCmds="Automation RunTests OGInteractions"` (add -NullRHI to run headless)
+IMPLEMENT_MODULE(FDefaultModuleImpl, OGInteractionsTests)